@@ -0,0 +1,62 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+/*
+ * Times Batch::step() on a few workloads, with and without lane groups: the lanes only run the
+ * register instructions together, the others go through the interpreter of each instance.
+ * Usage: BENCH_BATCH [instances] [steps] [frequency]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Batch.h"
+
+namespace {
+  struct Workload {
+    const char * name;
+    std::vector<uint8_t> rom;
+  };
+
+  const std::vector<Workload> WORKLOADS = {
+          // Counts in V0 and V1: register instructions and jumps only
+          {"alu", {0x60, 0x00, 0x70, 0x01, 0x81, 0x04, 0x40, 0x20, 0x12, 0x00, 0x12, 0x02}},
+          // Draws a digit at a random position, then adds to the registers
+          {"draw",
+           {0xC0, 0x3F, 0xC1, 0x1F, 0xF2, 0x29, 0xD0, 0x15, 0x72, 0x01, 0x73, 0x02, 0x12, 0x00}},
+          // Stores a BCD and loads it back
+          {"memory", {0xA3, 0x00, 0x70, 0x01, 0xF0, 0x33, 0xF2, 0x65, 0x12, 0x02}},
+  };
+
+  double time_steps(const Workload & workload, unsigned int frequency, size_t instances,
+                    unsigned int steps, bool lanes) {
+    auto configuration =
+            std::make_shared<Configuration>("", frequency, false, false, false, false);
+    configuration->setSeed(1);
+    Batch batch(configuration, workload.rom, instances, 1, lanes);
+    std::vector<uint16_t> actions(instances, 0x0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int step = 0; step < steps; step++) { batch.step(actions.data()); }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+  }
+}// namespace
+
+int main(int argc, char ** argv) {
+  size_t instances = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+  unsigned int steps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500;
+  unsigned int frequency = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 500;
+
+  std::printf("%zu instances, %u steps at %u Hz, one thread\n", instances, steps, frequency);
+  std::printf("  workload  scalar ms  lanes ms  speedup\n");
+  for (const Workload & workload : WORKLOADS) {
+    double scalar = time_steps(workload, frequency, instances, steps, false);
+    double lanes = time_steps(workload, frequency, instances, steps, true);
+    std::printf("  %-8s  %9.1f  %8.1f  %6.2fx\n", workload.name, scalar, lanes, scalar / lanes);
+  }
+  return 0;
+}
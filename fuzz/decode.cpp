@@ -0,0 +1,47 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+/*
+ * libFuzzer target running random ROM images headless.
+ * The first 2 bytes of an input are the keys held down, the rest is the ROM loaded at 0x200.
+ * The machine is built once and brought back to its initial state from a snapshot before each
+ * input. Faults of the emulated program halt it and end the input normally: an exception, like a
+ * crash, is a finding.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Machine.h"
+
+namespace {
+  // 4 seconds at 500Hz, enough for many timer ticks while keeping executions short
+  const unsigned int CYCLES = 2000;
+  const mem::address_t ROM_START = 0x200;
+
+  std::shared_ptr<Configuration> make_configuration() {
+    // The ROM is loaded for each input, the machine starts from an empty one.
+    std::shared_ptr<Configuration> configuration =
+            std::make_shared<Configuration>("", 500, false, false, false, false);
+    configuration->setSeed(1);
+    return configuration;
+  }
+}// namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size) {
+  static Machine machine(make_configuration(), false);
+  static const Snapshot initial = machine.save();
+
+  if (size < 2) { return 0; }
+  size_t rom_size = std::min<size_t>(size - 2, mem::MEMORY_SIZE - ROM_START);
+
+  machine.restore(initial);
+  machine.interface_->keypad_->set_mask((data[0] << 8) + data[1]);
+  machine.romParser_->load(std::vector<uint8_t>(data + 2, data + 2 + rom_size));
+
+  machine.romParser_->run(CYCLES);
+  return 0;
+}
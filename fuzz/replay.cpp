@@ -0,0 +1,31 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+/*
+ * Entry point of the fuzzing targets for compilers without libFuzzer: runs each input file given
+ * on the command line once, to replay a corpus or a crash under the sanitizers.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size);
+
+int main(int argc, char ** argv) {
+  for (int i = 1; i < argc; i++) {
+    std::ifstream source(argv[i], std::ios_base::binary);
+    if (!source) {
+      std::cerr << "Unable to open " << argv[i] << "\n";
+      return 1;
+    }
+    std::vector<uint8_t> input((std::istreambuf_iterator<char>(source)),
+                               std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  std::cout << "Ran " << argc - 1 << " inputs\n";
+  return 0;
+}
@@ -0,0 +1,72 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_AOT_H
+#define CHIP8_AOT_H
+
+/*
+ * Interface between the interpreter and the native code that CHIP8_AOT generates from a ROM.
+ * The generated code only depends on this header.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Incremented when the state layout or the symbols below change
+#define CHIP8_AOT_ABI_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Registers the native code reads and writes directly. The interpreter copies them in before
+ * running it, and back once it returns.
+ */
+struct chip8_aot_state {
+  uint8_t v[16];
+  uint16_t i;
+  uint16_t pc;
+  uint8_t dt;
+
+  /**
+   * Runs an instruction the native code does not implement through the interpreter. pc must
+   * point after the opcode, as it does once fetched: on the operand of an F000.
+   * @returns Non-zero if the native code must return: the CPU halted or exited, or the program
+   * overwrote its own code.
+   */
+  int (*exec)(struct chip8_aot_state * state, uint16_t opcode);
+
+  // Owner of exec
+  void * user;
+};
+
+/**
+ * Runs instructions from state->pc, until max instructions were executed or the program leaves
+ * the compiled code.
+ * @returns The number of instructions executed, 0 if state->pc is not compiled.
+ */
+typedef unsigned int (*chip8_aot_run_t)(struct chip8_aot_state * state, unsigned int max);
+
+extern const unsigned int chip8_aot_abi_version;
+// chip8_aot_hash() of the compiled ROM
+extern const uint64_t chip8_aot_rom_hash;
+// One bit per memory address holding compiled code, LSB first
+extern const uint8_t chip8_aot_code_map[];
+extern const unsigned int chip8_aot_code_map_size;
+unsigned int chip8_aot_run(struct chip8_aot_state * state, unsigned int max);
+
+/**
+ * 64-bit FNV-1a hash of a ROM.
+ */
+static inline uint64_t chip8_aot_hash(const uint8_t * rom, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; i++) { hash = (hash ^ rom[i]) * 0x100000001b3ULL; }
+  return hash;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CHIP8_AOT_H
@@ -0,0 +1,133 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_BATCH_H
+#define CHIP8_BATCH_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Configuration.h"
+#include "Display.h"
+#include "LaneGroup.h"
+#include "Machine.h"
+
+/**
+ * State of an instance after a step, same values as the C interface.
+ */
+enum class Status : uint8_t { running, halted, exited, faulted };
+
+/**
+ * Many headless instances of the same ROM stepping together, one frame per step, for
+ * reinforcement learning environments.
+ * Inputs and outputs are structures of arrays: one keypad mask per instance in, and one frame
+ * buffer and one status per instance out, each in a single buffer allocated once. Instances are
+ * split in contiguous slices between a fixed pool of threads, so a step allocates nothing.
+ * By default, instances run in lane groups of LaneGroup::LANES, executing together while they are
+ * at the same instruction.
+ */
+class Batch {
+public:
+  /**
+   * @param configuration Shared by every instance. A non-zero seed gives instance n the seed
+   * seed + n.
+   * @param rom
+   * @param size Number of instances.
+   * @param threads Threads stepping the instances, the calling thread included.
+   * @param lanes Runs the instances in lane groups, otherwise one after the other.
+   * @throws std::runtime_error if size or threads is 0, or the ROM does not fit in the memory
+   */
+  Batch(const std::shared_ptr<Configuration> & configuration, const std::vector<uint8_t> & rom,
+        size_t size, unsigned int threads, bool lanes = true);
+  ~Batch();
+
+  Batch(const Batch &) = delete;
+  Batch & operator=(const Batch &) = delete;
+
+  /**
+   * Runs every instance up to its next timer tick, after setting its keys.
+   * @param actions Keys held down by each instance, bit n for key n.
+   */
+  void step(const uint16_t * actions);
+
+  /**
+   * Brings an instance back to its state after the ROM was loaded.
+   * @param index
+   */
+  void reset(size_t index);
+
+  size_t size() const;
+
+  /**
+   * @returns The frame buffers after the last step: for each instance, for each plane,
+   * Display::MAX_SIZE_Y rows.
+   */
+  const Display::row_t * get_observations() const;
+
+  /**
+   * @returns The status of each instance after the last step.
+   */
+  const Status * get_status() const;
+
+  /**
+   * @returns The state fingerprint of each instance after the last step, see Machine::get_hash().
+   */
+  const uint64_t * get_hashes() const;
+
+  /**
+   * @param index
+   * @returns The instance, to inspect or change its state between steps.
+   */
+  Machine & get_machine(size_t index);
+
+  /**
+   * @returns The lane-wise execution counters of all the groups, zero without lane groups.
+   */
+  LaneStats get_lane_stats() const;
+
+  // Rows of an observation
+  static constexpr size_t OBSERVATION_ROWS = Display::PLANES * Display::MAX_SIZE_Y;
+
+private:
+  std::vector<Machine> machines_;
+  std::vector<LaneGroup> groups_;
+  std::vector<Snapshot> initial_;
+  std::vector<Display::row_t> observations_;
+  std::vector<Status> status_;
+  std::vector<uint64_t> hashes_;
+
+  // Pool: the workers wait for a new generation, step their slice and report back
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable started_;
+  std::condition_variable finished_;
+  unsigned long generation_ = 0;
+  unsigned int running_ = 0;
+  bool stopping_ = false;
+  const uint16_t * actions_ = nullptr;
+
+  /**
+   * Worker thread body.
+   * @param slice Index of the slice it steps, 0 being the calling thread's.
+   */
+  void work(unsigned int slice);
+
+  /**
+   * Steps the instances of a slice, with actions_. Slices are made of whole lane groups.
+   * @param slice
+   */
+  void step_slice(unsigned int slice);
+
+  /**
+   * Copies the frame buffer, the status and the fingerprint of an instance to the output buffers.
+   * @param index
+   */
+  void observe(size_t index);
+};
+
+
+#endif//CHIP8_BATCH_H
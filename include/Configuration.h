@@ -6,6 +6,9 @@
 
 #include "string"
 
+#include "Fault.h"
+#include "Keypad.h"
+
 class Configuration {
 public:
   Configuration(const std::string & romPath, int frequency, bool c8Xy68XyESetsVy,
@@ -42,6 +45,126 @@ public:
    */
   int getFrequency() const;
 
+  /**
+   * @returns keyboard keys bound to the keypad keys 0 to F.
+   */
+  const std::string & getKeymap() const;
+
+  /**
+   * @param keymap keyboard keys bound to the keypad keys 0 to F.
+   */
+  void setKeymap(const std::string & keymap);
+
+  /**
+   * @returns requested audio sample rate in Hz.
+   */
+  int getAudioSampleRate() const;
+
+  /**
+   * @param sampleRate requested audio sample rate in Hz.
+   */
+  void setAudioSampleRate(int sampleRate);
+
+  /**
+   * @returns requested audio buffer size in samples.
+   */
+  int getAudioBufferSamples() const;
+
+  /**
+   * @param bufferSamples requested audio buffer size in samples.
+   */
+  void setAudioBufferSamples(int bufferSamples);
+
+  /**
+   * @returns frequent instruction sequences are dispatched as superinstructions.
+   */
+  bool isFusion() const;
+
+  /**
+   * @param fusion dispatch frequent instruction sequences as superinstructions.
+   */
+  void setFusion(bool fusion);
+
+  /**
+   * @returns shared object compiled from the ROM by CHIP8_AOT, empty to interpret the ROM.
+   */
+  const std::string & getNativePath() const;
+
+  /**
+   * @param nativePath shared object compiled from the ROM by CHIP8_AOT.
+   */
+  void setNativePath(const std::string & nativePath);
+
+  /**
+   * @returns loops only a timer tick can exit are fast-forwarded.
+   */
+  bool isIdleSkip() const;
+
+  /**
+   * @param idleSkip fast-forward the loops only a timer tick can exit.
+   */
+  void setIdleSkip(bool idleSkip);
+
+  /**
+   * @returns seed of the Cxkk random numbers, 0 for a random seed.
+   */
+  unsigned int getSeed() const;
+
+  /**
+   * @param seed seed of the Cxkk random numbers, 0 for a random seed.
+   */
+  void setSeed(unsigned int seed);
+
+  /**
+   * @returns what the CPU does when the program faults.
+   */
+  FaultPolicy getFaultPolicy() const;
+
+  /**
+   * @param faultPolicy what the CPU does when the program faults.
+   */
+  void setFaultPolicy(FaultPolicy faultPolicy);
+
+  /**
+   * @returns most frames skipped in a row when the host falls behind.
+   */
+  unsigned int getMaxFrameskip() const;
+
+  /**
+   * @returns Frames run ahead of the presented one, 0 if disabled.
+   */
+  unsigned int getRunAhead() const;
+
+  /**
+   * @param runAhead frames run ahead of the presented one to hide the input latency, 0 to disable.
+   */
+  void setRunAhead(unsigned int runAhead);
+
+  /**
+   * @param maxFrameskip most frames skipped in a row when the host falls behind, 0 for none.
+   */
+  void setMaxFrameskip(unsigned int maxFrameskip);
+
+  /**
+   * @returns POSIX shared memory name the frames are published to, empty if disabled.
+   */
+  const std::string & getExportName() const;
+
+  /**
+   * @param exportName POSIX shared memory name the frames are published to, empty to disable.
+   */
+  void setExportName(const std::string & exportName);
+
+  /**
+   * @returns Y4M video output path, - for the standard output, empty if disabled.
+   */
+  const std::string & getVideoPath() const;
+
+  /**
+   * @param videoPath Y4M video output path, - for the standard output, empty to disable.
+   */
+  void setVideoPath(const std::string & videoPath);
+
 private:
   std::string rom_path_;
   int frequency_;
@@ -49,6 +172,18 @@ private:
   bool c_Bnnn_becomes_Bxnn_;      // arg 2
   bool c_Fx55_Fx65_increments_i_; // arg 3
   bool c_8xy1_8xy2_8xy3_reset_vf_;// arg 4
+  std::string keymap_ = DEFAULT_KEYMAP;
+  int audio_sample_rate_ = 20000;
+  int audio_buffer_samples_ = 100;
+  bool fusion_ = true;
+  std::string native_path_;
+  bool idle_skip_ = true;
+  unsigned int seed_ = 0;
+  FaultPolicy fault_policy_ = FaultPolicy::halt;
+  unsigned int max_frameskip_ = 4;
+  unsigned int run_ahead_ = 0;
+  std::string export_name_;
+  std::string video_path_;
 };
 
 
@@ -0,0 +1,199 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_DISPLAY_H
+#define CHIP8_DISPLAY_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+#ifndef CHIP8_PLANES
+// 1 for CHIP-8 and SUPER-CHIP, up to 4 for XO-CHIP
+#define CHIP8_PLANES 1
+#endif
+
+// ARGB color of each palette index, bit n of the index being the pixel state in plane n
+const std::array<uint32_t, 16> PALETTE = {
+        0xFF000000, 0xFFFFFFFF, 0xFFAAAAAA, 0xFF555555, 0xFFFF0000, 0xFF00FF00,
+        0xFF0000FF, 0xFFFFFF00, 0xFF880000, 0xFF008800, 0xFF000088, 0xFF888800,
+        0xFFFF00FF, 0xFF00FFFF, 0xFF880088, 0xFF008888};
+
+/**
+ * Frame buffer, 64x32 or 128x64 in SUPER-CHIP high resolution, made of PLANES bitplanes.
+ * Each row of a plane is packed in one 128-bit word, the most significant bit being the leftmost
+ * pixel, so sprites and scrolling are applied to whole rows at once.
+ * Drawing, clearing and scrolling only affect the planes selected by the XO-CHIP plane mask.
+ */
+class Display {
+public:
+  using row_t = unsigned __int128;
+
+  static const unsigned short int MAX_SIZE_X = 128;
+  static const unsigned short int MAX_SIZE_Y = 64;
+  static const uint8_t PLANES = CHIP8_PLANES;
+  static_assert(PLANES >= 1 && PLANES <= 4, "XO-CHIP supports 1 to 4 planes");
+
+  Display();
+
+  /**
+   * @returns Width of the current resolution.
+   */
+  unsigned short int size_x() const;
+
+  /**
+   * @returns Height of the current resolution.
+   */
+  unsigned short int size_y() const;
+
+  /**
+   * @returns The display is in 128x64 high resolution.
+   */
+  bool is_hires() const;
+
+  /**
+   * Switches between 64x32 and 128x64, clearing all the planes.
+   * @param hires
+   */
+  void set_hires(bool hires);
+
+  /**
+   * Selects the planes affected by the next operations, ignoring the planes that do not exist.
+   * @param mask Bit n selects plane n.
+   */
+  void select_planes(uint8_t mask);
+
+  /**
+   * @returns The selected planes mask.
+   */
+  uint8_t get_planes() const;
+
+  /**
+   * Turns all pixels of the selected planes off.
+   */
+  void clear();
+
+  /**
+   * Returns given pixel state.
+   * @param x
+   * @param y
+   * @returns The pixel is on in any plane.
+   * @throws std::runtime_error if the pixel is out of the current resolution
+   */
+  bool is_pixel_on(int x, int y) const;
+
+  /**
+   * @param x
+   * @param y
+   * @returns The palette index of the pixel, bit n being its state in plane n.
+   * @throws std::runtime_error if the pixel is out of the current resolution
+   */
+  uint8_t get_color(int x, int y) const;
+
+  /**
+   * Set a pixel of the selected planes to an on/off state.
+   * @param x
+   * @param y
+   * @param on
+   */
+  void set_pixel_state(unsigned short int x, unsigned short int y, bool on);
+
+  /**
+   * XORs a sprite on the selected planes, wrapping around the edges.
+   * @param x
+   * @param y
+   * @param rows Sprite rows, the leftmost pixel being bit width - 1. Holds height rows for each
+   * selected plane, in plane order.
+   * @param height Number of rows per plane.
+   * @param width Number of pixels per row, up to 16.
+   * @returns A pixel was turned off.
+   */
+  bool draw_sprite(uint8_t x, uint8_t y, const uint16_t * rows, uint8_t height, uint8_t width);
+
+  /**
+   * Scrolls the screen down by n pixels.
+   * @param n
+   */
+  void scroll_down(uint8_t n);
+
+  /**
+   * Scrolls the screen up by n pixels. (XO-CHIP)
+   * @param n
+   */
+  void scroll_up(uint8_t n);
+
+  /**
+   * Scrolls the screen right by n pixels.
+   * @param n
+   */
+  void scroll_right(uint8_t n);
+
+  /**
+   * Scrolls the screen left by n pixels.
+   * @param n
+   */
+  void scroll_left(uint8_t n);
+
+  /**
+   * @param y
+   * @param plane
+   * @returns The packed pixels of row y in the plane.
+   */
+  row_t get_row(unsigned short int y, uint8_t plane = 0) const;
+
+  /**
+   * @param plane
+   * @returns The MAX_SIZE_Y rows of the plane, updated in place.
+   */
+  const row_t * get_plane(uint8_t plane) const;
+
+  /**
+   * @returns Fingerprint of the planes, the resolution and the plane mask, see fingerprint::.
+   */
+  uint64_t get_hash() const;
+
+private:
+  using plane_t = std::array<row_t, MAX_SIZE_Y>;
+
+  std::array<plane_t, PLANES> planes_;
+  uint8_t plane_mask_ = 0x1;
+  bool hires_ = false;
+  // Sum of the fingerprints of every row, updated with the rows
+  uint64_t rows_hash_ = 0;
+
+  /**
+   * @param plane
+   * @param y
+   * @param row
+   * @returns The fingerprint of a row.
+   */
+  static uint64_t hash_row(uint8_t plane, unsigned short int y, row_t row);
+
+  /**
+   * Replaces a row, updating the fingerprint.
+   * @param plane
+   * @param y
+   * @param row
+   */
+  void set_row(uint8_t plane, unsigned short int y, row_t row);
+
+  /**
+   * Recomputes the fingerprint of all the rows, after they were moved.
+   */
+  void rehash();
+
+  /**
+   * @param plane
+   * @returns The plane is selected.
+   */
+  bool is_selected(uint8_t plane) const;
+
+  /**
+   * @returns The bits of a row that are visible in the current resolution.
+   */
+  row_t row_mask() const;
+};
+
+
+#endif//CHIP8_DISPLAY_H
@@ -0,0 +1,193 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_EXPLORER_H
+#define CHIP8_EXPLORER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "Configuration.h"
+#include "Fault.h"
+#include "Machine.h"
+#include "Memory.h"
+
+/**
+ * What an input sequence led to.
+ */
+enum class FindingKind : uint8_t {
+  // The program stopped on a fault
+  fault,
+  // No input changes the state anymore
+  hang,
+  // The program exited with 00FD
+  exit,
+  count
+};
+
+constexpr std::array<const char *, static_cast<size_t>(FindingKind::count)> FINDING_NAMES = {
+        "fault", "hang", "exit"};
+
+struct Finding {
+  FindingKind kind;
+  // Fault::none unless kind is fault
+  Fault fault;
+  mem::address_t pc;
+  // Keys held for each input, from the initial state
+  std::vector<uint16_t> inputs;
+};
+
+struct ExplorerStats {
+  // Inputs applied from the initial state to the current frontier
+  unsigned int depth;
+  // Distinct states reached, the initial one included
+  size_t states;
+  // States the next level starts from
+  size_t frontier;
+  // Distinct instruction addresses executed
+  size_t unique_pcs;
+  // Elapsed time of the levels, in seconds
+  double seconds;
+};
+
+/**
+ * Headless search over keypad inputs, to find the input sequences that make a ROM fault or hang.
+ * Each level applies every input to every state of the frontier, holding it for a few frames,
+ * from a snapshot of the state. Reached states are deduplicated by fingerprint, see
+ * Machine::get_hash(), so the random number generator state is not told apart.
+ * The frontier is expanded breadth first, or limited to the states that executed the most
+ * instructions not executed before when a beam width is given. The states of a level are
+ * expanded in parallel by a fixed pool of threads, each running its own scratch machine, both kept
+ * for the lifetime of the explorer. The results are merged in the frontier order, so the search
+ * does not depend on the number of threads.
+ */
+class Explorer {
+public:
+  /**
+   * @param configuration Core, quirks and seed of the machines.
+   * @param rom
+   * @param threads Threads expanding a level, the calling thread included.
+   * @param beam_width Most states kept per level, 0 for a breadth first search.
+   * @param frames Frames each input is held for.
+   * @param inputs Keypad masks tried from every state, get_single_keys() if empty.
+   * @throws std::runtime_error if the ROM does not fit in the memory, threads or frames is 0
+   */
+  Explorer(const std::shared_ptr<Configuration> & configuration, const std::vector<uint8_t> & rom,
+           unsigned int threads, size_t beam_width = 0, unsigned int frames = 4,
+           const std::vector<uint16_t> & inputs = {});
+  ~Explorer();
+
+  Explorer(const Explorer &) = delete;
+  Explorer & operator=(const Explorer &) = delete;
+
+  /**
+   * Applies every input to every state of the frontier, which becomes the new states reached.
+   * @returns The new frontier is not empty.
+   */
+  bool expand();
+
+  const ExplorerStats & get_stats() const;
+
+  /**
+   * @returns The faults, hangs and exits found so far, in the order they were found.
+   */
+  const std::vector<Finding> & get_findings() const;
+
+  /**
+   * @param address
+   * @returns An instruction at address was executed.
+   */
+  bool is_covered(mem::address_t address) const;
+
+  /**
+   * @returns No key, then each key alone.
+   */
+  static std::vector<uint16_t> get_single_keys();
+
+private:
+  // A reached state: where it comes from, for the input sequences of the findings
+  struct Trace {
+    size_t parent;
+    uint16_t input;
+  };
+
+  struct Node {
+    size_t trace;
+    uint64_t hash;
+    Snapshot snapshot;
+  };
+
+  // Result of an input applied to a frontier state
+  struct Child {
+    uint16_t input;
+    uint64_t hash;
+    Snapshot snapshot;
+    // Distinct addresses executed, sorted
+    std::vector<mem::address_t> pcs;
+  };
+
+  std::shared_ptr<Configuration> configuration_;
+  unsigned int threads_;
+  size_t beam_width_;
+  unsigned int frames_;
+  std::vector<uint16_t> inputs_;
+
+  std::vector<Trace> traces_;
+  std::vector<Node> frontier_;
+  std::unordered_set<uint64_t> visited_;
+  std::vector<bool> coverage_;
+  std::vector<Finding> findings_;
+  ExplorerStats stats_{};
+
+  // One scratch machine per thread, the calling thread's first
+  std::vector<Machine> machines_;
+  // Children of each frontier state, for the level being expanded
+  std::vector<std::vector<Child>> children_;
+  // Next frontier state to expand
+  std::atomic<size_t> next_{0};
+
+  // Pool: the workers wait for a new level, expand states until none is left and report back
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable started_;
+  std::condition_variable finished_;
+  unsigned long generation_ = 0;
+  unsigned int running_ = 0;
+  bool stopping_ = false;
+
+  /**
+   * Worker thread body.
+   * @param thread Index of its scratch machine, 0 being the calling thread's.
+   */
+  void work(unsigned int thread);
+
+  /**
+   * Expands the frontier states not taken by another thread yet.
+   * @param machine Scratch machine of the calling thread.
+   */
+  void expand_nodes(Machine & machine);
+
+  /**
+   * Applies every input to a state.
+   * @param machine Scratch machine of the calling thread.
+   * @param node
+   * @returns One child per input.
+   */
+  std::vector<Child> expand_node(Machine & machine, const Node & node) const;
+
+  /**
+   * @param trace
+   * @returns The inputs from the initial state to a reached state.
+   */
+  std::vector<uint16_t> get_inputs(size_t trace) const;
+};
+
+
+#endif//CHIP8_EXPLORER_H
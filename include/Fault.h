@@ -0,0 +1,43 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_FAULT_H
+#define CHIP8_FAULT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Errors of the emulated program. They are stored in the fault register instead of being thrown,
+ * so the execution path never unwinds.
+ */
+enum class Fault : uint8_t {
+  none,
+  unknown_opcode,
+  // CALL past RegisterManager::STACK_SIZE levels
+  stack_overflow,
+  // RET with an empty stack
+  stack_underflow,
+  // Fetch at PC, or memory access from I, past the end of the memory
+  address_out_of_range,
+  count
+};
+
+constexpr std::array<const char *, static_cast<size_t>(Fault::count)> FAULT_NAMES = {
+        "none", "unknown opcode", "stack overflow", "stack underflow", "address out of range"};
+
+/**
+ * What the CPU does when the program faults. The faulting instruction never has any effect.
+ */
+enum class FaultPolicy : uint8_t {
+  // Stops until the fault is cleared
+  halt,
+  // Raises SIGTRAP, so an attached debugger breaks on the fault, then halts
+  trap,
+  // Counts the fault and goes on with the next instruction
+  ignore
+};
+
+
+#endif//CHIP8_FAULT_H
@@ -0,0 +1,44 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_FINGERPRINT_H
+#define CHIP8_FINGERPRINT_H
+
+#include <cstdint>
+
+/**
+ * 64-bit state fingerprints. The memory and the frame buffer are fingerprinted as the sum of the
+ * fingerprints of their parts, each keyed by its position: when a part changes, the sum is
+ * updated in constant time by swapping its old fingerprint for the new one.
+ * Not cryptographic: equal fingerprints mean equal states with a probability of 1 - 2^-64 per
+ * comparison of unrelated states.
+ */
+namespace fingerprint {
+  /**
+   * splitmix64 finalizer, every bit of the input flips every bit of the output with a
+   * probability close to 1/2.
+   * @param value
+   */
+  constexpr uint64_t mix(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+  }
+
+  /**
+   * @param key Part of the state, or fingerprint the value is chained to.
+   * @param value
+   * @returns The fingerprint of a value at a position of the state.
+   */
+  constexpr uint64_t of(uint64_t key, uint64_t value) {
+    return mix(mix(key) + value);
+  }
+
+  // Keys of the parts of the state
+  const uint64_t MEMORY = 0x1ULL << 32;
+  const uint64_t DISPLAY = 0x2ULL << 32;
+  const uint64_t REGISTERS = 0x3ULL << 32;
+}// namespace fingerprint
+
+
+#endif//CHIP8_FINGERPRINT_H
@@ -0,0 +1,150 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_FRAMEEXPORT_H
+#define CHIP8_FRAMEEXPORT_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "Display.h"
+#include "FramePacer.h"
+#include "Machine.h"
+
+/**
+ * Frame published by FrameExport, as laid out in the shared memory. Fixed width fields only, so
+ * processes written in other languages can read it.
+ */
+struct ExportedFrame {
+  // Timer periods run
+  uint64_t frame;
+  // Instructions run
+  uint64_t instructions;
+  uint64_t faults;
+  // Periods that ended after their deadline, and frames not presented to catch up
+  uint64_t late;
+  uint64_t skipped;
+  uint16_t pc;
+  // Keypad keys held, bit n for key n
+  uint16_t keys;
+  // Current resolution
+  uint16_t width;
+  uint16_t height;
+  uint8_t dt;
+  uint8_t st;
+  // Fault, see FAULT_NAMES
+  uint8_t fault;
+  // FLAG_ bits
+  uint8_t flags;
+  uint8_t reserved[4];
+  // Palette index of each pixel, bit n being its state in plane n. Only the width x height top
+  // left pixels are displayed.
+  uint8_t pixels[Display::MAX_SIZE_Y][Display::MAX_SIZE_X];
+
+  static constexpr uint8_t FLAG_HALTED = 0x1;
+  static constexpr uint8_t FLAG_EXITED = 0x2;
+  static constexpr uint8_t FLAG_FAULTED = 0x4;
+  static constexpr uint8_t FLAG_HIRES = 0x8;
+};
+
+/**
+ * Shared memory layout: a header, then the frame as 64-bit words guarded by a seqlock. The
+ * sequence is odd while the frame is written; a reader copies the words between two equal even
+ * reads of it, and retries otherwise.
+ */
+struct FrameRegion {
+  static constexpr uint32_t MAGIC = 0x42463843;// "C8FB"
+  static constexpr size_t WORDS = sizeof(ExportedFrame) / 8;
+
+  uint32_t magic;
+  // sizeof(ExportedFrame), to detect a reader built against another layout
+  uint32_t frame_size;
+  // Number of frames published times 2, plus 1 while one is written
+  alignas(64) std::atomic<uint64_t> sequence;
+  alignas(64) std::array<std::atomic<uint64_t>, WORDS> words;
+};
+
+static_assert(sizeof(ExportedFrame) % 8 == 0, "The frame is copied as 64-bit words");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "The seqlock is shared with other processes");
+
+/**
+ * Publishes the frame buffer, the keys and the core counters to a POSIX shared memory object,
+ * once per frame. Other processes map it with FrameExportReader, or any mmap() of the same
+ * layout, and read the frames without copying them through a pipe or a socket. Publishing never
+ * waits for the readers.
+ */
+class FrameExport {
+public:
+  /**
+   * Creates the shared memory object, replacing one of the same name.
+   * @param name POSIX shared memory name, as /chip8.
+   * @throws std::runtime_error if the object cannot be created or mapped
+   */
+  explicit FrameExport(const std::string & name);
+  ~FrameExport();
+
+  FrameExport(const FrameExport &) = delete;
+  FrameExport & operator=(const FrameExport &) = delete;
+
+  /**
+   * Publishes the current state of a machine. The pixels are only converted again when the
+   * frame buffer fingerprint changed.
+   * @param machine
+   * @param stats Frame pacing counters, zero if not paced.
+   */
+  void publish(const Machine & machine, const FrameStats & stats = {});
+
+  /**
+   * @returns The number of frames published.
+   */
+  uint64_t get_published() const;
+
+private:
+  std::string name_;
+  FrameRegion * region_ = nullptr;
+  // Staged frame, copied to the region as a whole
+  ExportedFrame frame_{};
+  uint64_t display_hash_ = 0;
+  bool pixels_valid_ = false;
+};
+
+/**
+ * Maps a shared memory object created by FrameExport, read only.
+ */
+class FrameExportReader {
+public:
+  /**
+   * @param name
+   * @throws std::runtime_error if the object does not exist or has another layout
+   */
+  explicit FrameExportReader(const std::string & name);
+  ~FrameExportReader();
+
+  FrameExportReader(const FrameExportReader &) = delete;
+  FrameExportReader & operator=(const FrameExportReader &) = delete;
+
+  /**
+   * Copies the last frame published.
+   * @param frame
+   * @returns A whole frame was copied, false if none was published yet or every attempt raced
+   * with the writer.
+   */
+  bool read(ExportedFrame & frame) const;
+
+  /**
+   * @returns The number of frames published, without reading them.
+   */
+  uint64_t get_published() const;
+
+private:
+  // Copies given up after, the writer publishing faster than the frame is copied
+  static constexpr unsigned int MAX_ATTEMPTS = 64;
+
+  const FrameRegion * region_ = nullptr;
+};
+
+
+#endif//CHIP8_FRAMEEXPORT_H
@@ -0,0 +1,81 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_FRAMEPACER_H
+#define CHIP8_FRAMEPACER_H
+
+#include <chrono>
+
+/**
+ * Frame pacing counters.
+ */
+struct FrameStats {
+  // Timer periods run
+  unsigned long frames;
+  // Periods that ended after their deadline
+  unsigned long late;
+  // Frames queued for display
+  unsigned long presented;
+  // Frames not presented to catch up
+  unsigned long skipped;
+  // Times the schedule was given up, after a stall longer than MAX_LATENESS
+  unsigned long resyncs;
+  // In milliseconds
+  double max_lateness;
+};
+
+/**
+ * Keeps the emulation on a fixed real time schedule. When the host falls behind, the following
+ * periods run back to back to catch up, and their frames are not presented, up to a maximum
+ * number in a row. The emulation itself is never skipped.
+ */
+class FramePacer {
+public:
+  using clock = std::chrono::steady_clock;
+
+  // Beyond this, the delay is not caught up: the schedule restarts from now
+  static constexpr clock::duration MAX_LATENESS = std::chrono::milliseconds(250);
+
+  /**
+   * @param max_skip Most frames skipped in a row, 0 presents them all.
+   */
+  explicit FramePacer(unsigned int max_skip);
+
+  /**
+   * Starts a period, right after the previous one.
+   * @param period
+   * @param now
+   * @returns The deadline of the period, to sleep until.
+   */
+  clock::time_point begin(clock::duration period, clock::time_point now);
+
+  /**
+   * Ends the period, measuring how late it is.
+   * @param now
+   */
+  void end(clock::time_point now);
+
+  /**
+   * Must be called once per period whose frame changed, after end().
+   * @returns The frame is presented, false if it is skipped to catch up.
+   */
+  bool should_present();
+
+  /**
+   * Counts a frame as presented, once it was actually queued for display.
+   */
+  void mark_presented();
+
+  const FrameStats & get_stats() const;
+
+private:
+  unsigned int max_skip_;
+  clock::time_point deadline_;
+  bool started_ = false;
+  bool late_ = false;
+  unsigned int skipped_in_a_row_ = 0;
+  FrameStats stats_{};
+};
+
+
+#endif//CHIP8_FRAMEPACER_H
@@ -0,0 +1,57 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_FRONTEND_H
+#define CHIP8_FRONTEND_H
+
+#include <cstdint>
+#include <memory>
+
+#include "Display.h"
+#include "Keypad.h"
+
+/**
+ * What the instructions see of the outside: the frame buffer and the keypad. Used as is, the
+ * machine runs headless; Interface implements it on top of SDL.
+ */
+class Frontend {
+public:
+  virtual ~Frontend() = default;
+
+  /**
+   * Notes that the frame buffer changed, the frame being presented later by the owner of the
+   * window, if any.
+   */
+  void render();
+
+  /**
+   * @returns The frame buffer changed since the last call.
+   */
+  bool take_render_request();
+
+  /**
+   * @param key
+   * @return Is the key pressed.
+   */
+  bool is_pressed(uint8_t key) const;
+
+  /**
+   * @return The lowest pressed key. If none returns 0x10.
+   */
+  uint8_t get_any_pressed() const;
+
+  /**
+   * Called on an ST write that starts a beep.
+   */
+  virtual void mark_beep_request() {}
+
+  std::shared_ptr<Display> display_ = std::make_shared<Display>();
+  std::shared_ptr<Keypad> keypad_ = std::make_shared<Keypad>();
+
+private:
+  // The frame buffer changed, only used by the emulation
+  bool render_requested_ = false;
+};
+
+
+#endif//CHIP8_FRONTEND_H
@@ -4,12 +4,13 @@
 #ifndef CHIP8_INSTRUCTIONS_H
 #define CHIP8_INSTRUCTIONS_H
 
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <random>
 
 #include "Configuration.h"
-#include "Interface.h"
+#include "Frontend.h"
 #include "Memory.h"
 #include "register/RegisterManager.h"
 
@@ -21,24 +22,52 @@ public:
   Instructions(const std::shared_ptr<Configuration> & configuration,
                const std::shared_ptr<mem::Memory> & memory,
                const std::shared_ptr<reg::RegisterManager> & registers,
-               const std::shared_ptr<Interface> & interface);
+               const std::shared_ptr<Frontend> & interface);
 
 private:
   std::shared_ptr<Configuration> configuration_;
   std::shared_ptr<mem::Memory> memory_;
   std::shared_ptr<reg::RegisterManager> registers_;
-  std::shared_ptr<Interface> interface_;
+  std::shared_ptr<Frontend> interface_;
 
   std::random_device rd;
   std::mt19937 mt;
   std::unique_ptr<std::uniform_int_distribution<uint8_t>> randbyte;
 
-  // Temporary variables used by instructions
-  int x_, y_;
-  uint8_t sprite_byte_;
-  bool sprite_pixel_is_on_, disp_pixel_is_on_;
+  // Sprite being drawn by Dxyn, 16 rows for each plane
+  std::array<uint16_t, 16 * Display::PLANES> sprite_;
+
+  // Running frames that are thrown away, see set_speculative()
+  bool speculative_ = false;
+
+  /**
+   * Skips the next instruction, which is 4 bytes long if it is F000 NNNN.
+   */
+  void skip_next();
+
+  /**
+   * Checks a memory access from I, raising Fault::address_out_of_range if it does not fit.
+   * @param size Number of bytes accessed.
+   * @returns The access is within the memory.
+   */
+  bool check_range(unsigned int size);
 
 public:
+  /**
+   * @returns State of the Cxkk random number generator, for snapshots.
+   */
+  const std::mt19937 & get_random() const;
+
+  /**
+   * @param random State of the Cxkk random number generator.
+   */
+  void set_random(const std::mt19937 & random);
+
+  /**
+   * @param speculative The frames run are thrown away: ST writes do not request a beep.
+   */
+  void set_speculative(bool speculative);
+
   void sys_0nnn(address_t addr);
 
   /**
@@ -51,9 +80,54 @@ public:
    * 00EE - RET
    * Return from a subroutine.
    * The interpreter sets the program counter to the address at the top of the stack, then subtracts 1 from the stack pointer.
+   * Raises Fault::stack_underflow if the stack is empty.
    */
   void ret_00EE();
 
+  /**
+   * 00Cn - SCD nibble
+   * Scroll display n lines down. (SUPER-CHIP)
+   * @param n
+   */
+  void scd_00Cn(uint8_t n);
+
+  /**
+   * 00Dn - SCU nibble
+   * Scroll display n lines up. (XO-CHIP)
+   * @param n
+   */
+  void scu_00Dn(uint8_t n);
+
+  /**
+   * 00FB - SCR
+   * Scroll display 4 pixels right. (SUPER-CHIP)
+   */
+  void scr_00FB();
+
+  /**
+   * 00FC - SCL
+   * Scroll display 4 pixels left. (SUPER-CHIP)
+   */
+  void scl_00FC();
+
+  /**
+   * 00FD - EXIT
+   * Exit the interpreter. (SUPER-CHIP)
+   */
+  void exit_00FD();
+
+  /**
+   * 00FE - LOW
+   * Disable high resolution graphic mode, back to 64x32. (SUPER-CHIP)
+   */
+  void low_00FE();
+
+  /**
+   * 00FF - HIGH
+   * Enable 128x64 high resolution graphic mode. (SUPER-CHIP)
+   */
+  void high_00FF();
+
   /**
    * 1nnn - JP addr
    * Jump to location nnn.
@@ -67,6 +141,7 @@ public:
    * Call subroutine at nnn.
    * The interpreter increments the stack pointer, then puts the current PC on the top of the stack. The PC is then set to nnn.
    * @param addr
+   * Raises Fault::stack_overflow if the stack holds STACK_SIZE addresses already.
    */
   void call_2nnn(address_t addr);
 
@@ -97,6 +172,24 @@ public:
    */
   void se_5xy0(regnb_t vx, regnb_t vy);
 
+  /**
+   * 5xy2 - LD [I], Vx - Vy
+   * Store registers Vx through Vy in memory starting at location I, without changing I.
+   * The registers are stored in reverse order if x > y. (XO-CHIP)
+   * @param vx
+   * @param vy
+   */
+  void ld_5xy2(regnb_t vx, regnb_t vy);
+
+  /**
+   * 5xy3 - LD Vx - Vy, [I]
+   * Read registers Vx through Vy from memory starting at location I, without changing I.
+   * The registers are read in reverse order if x > y. (XO-CHIP)
+   * @param vx
+   * @param vy
+   */
+  void ld_5xy3(regnb_t vx, regnb_t vy);
+
   /**
    * 6xkk - LD Vx, byte
    * Set Vx = kk.
@@ -277,9 +370,16 @@ public:
    * Fx0A - LD Vx, K
    * Wait for a key press, store the value of the key in Vx.
    * All execution stops until a key is pressed, then the value of that key is stored in Vx.
+   * If no key is down the CPU is halted, see resume_Fx0A().
    * @param vx
    */
-  void ld_Fx0A(regnb_t vx);// todo input
+  void ld_Fx0A(regnb_t vx);
+
+  /**
+   * Completes a pending Fx0A if a key is pressed, storing it and resuming the CPU.
+   * @returns The CPU is running.
+   */
+  bool resume_Fx0A();
 
   /**
    * Fx15 - LD DT, Vx
@@ -297,6 +397,33 @@ public:
    */
   void ld_Fx18(regnb_t vx);
 
+  /**
+   * F000 NNNN - LD I, long NNNN
+   * Set I = NNNN, the 16-bit address following the instruction. (XO-CHIP)
+   * @param addr
+   */
+  void ld_F000(address_t addr);
+
+  /**
+   * Fn01 - PLANE n
+   * Select the bitplanes drawn, cleared and scrolled by the next instructions. (XO-CHIP)
+   * @param n
+   */
+  void plane_Fn01(uint8_t n);
+
+  /**
+   * F002 - AUDIO
+   * Load the 16 bytes audio pattern buffer from memory starting at location I. (XO-CHIP)
+   */
+  void audio_F002();
+
+  /**
+   * Fx3A - PITCH Vx
+   * Set the playback rate of the audio pattern buffer to 4000 * 2 ^ ((Vx - 64) / 48) Hz. (XO-CHIP)
+   * @param vx
+   */
+  void pitch_Fx3A(regnb_t vx);
+
   /**
    * Fx1E - ADD I, Vx
    * Set I = I + Vx.
@@ -313,6 +440,13 @@ public:
    */
   void ld_Fx29(regnb_t vx);
 
+  /**
+   * Fx30 - LD HF, Vx
+   * Set I = location of the 8x10 sprite for digit Vx. (SUPER-CHIP)
+   * @param vx
+   */
+  void ld_Fx30(regnb_t vx);
+
   /**
    * Fx33 - LD B, Vx
    * Store BCD representation of Vx in memory locations I, I+1, and I+2.
@@ -336,6 +470,66 @@ public:
    * @param vx
    */
   void ld_Fx65(regnb_t vx);
+
+  /**
+   * Fx75 - LD R, Vx
+   * Store V0 through Vx in the RPL user flags. (SUPER-CHIP)
+   * @param vx
+   */
+  void ld_Fx75(regnb_t vx);
+
+  /**
+   * Fx85 - LD Vx, R
+   * Read V0 through Vx from the RPL user flags. (SUPER-CHIP)
+   * @param vx
+   */
+  void ld_Fx85(regnb_t vx);
+
+  /**
+   * Annn, Dxyn - Superinstruction
+   * Set I = nnn, then display the n-byte sprite at I at (Vx, Vy).
+   * @param addr
+   * @param vx
+   * @param vy
+   * @param n
+   */
+  void ld_drw_Annn_Dxyn(address_t addr, regnb_t vx, regnb_t vy, uint8_t n);
+
+  /**
+   * 6xkk, Fx15 - Superinstruction
+   * Set Vx = kk, then delay timer = Vx.
+   * @param vx
+   * @param byte
+   */
+  void ld_ld_6xkk_Fx15(regnb_t vx, uint8_t byte);
+
+  /**
+   * 7xkk, 3xkk - Superinstruction
+   * Set Vx = Vx + add, then skip next instruction if Vx = cmp.
+   * @param vx
+   * @param add
+   * @param cmp
+   */
+  void add_se_7xkk_3xkk(regnb_t vx, uint8_t add, uint8_t cmp);
+
+  /**
+   * 7xkk, 4xkk - Superinstruction
+   * Set Vx = Vx + add, then skip next instruction if Vx != cmp.
+   * @param vx
+   * @param add
+   * @param cmp
+   */
+  void add_sne_7xkk_4xkk(regnb_t vx, uint8_t add, uint8_t cmp);
+
+  /**
+   * Fx07, 3xkk, 1nnn - Superinstruction
+   * Set Vx = delay timer, then jump to nnn unless Vx = kk. The PC must point to the 1nnn.
+   * @param vx
+   * @param byte
+   * @param addr
+   * @returns The jump was taken, i.e. the three instructions were executed.
+   */
+  bool ld_se_jp_Fx07_3xkk_1nnn(regnb_t vx, uint8_t byte, address_t addr);
 };
 
 
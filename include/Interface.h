@@ -8,142 +8,214 @@
 #include "SDL_audio.h"
 
 #include "iostream"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <unordered_map>
 
+#include "Display.h"
+#include "Frontend.h"
+#include "Keypad.h"
 #include "register/RegisterManager.h"
 
 const int AMPLITUDE = 500;
 const int SAMPLE_RATE = 20000;
+const int AUDIO_BUFFER_SAMPLES = 100;
+const double TONE_FREQUENCY = 220.0;
+// One period of the buzzer tone is stored in 2^WAVETABLE_BITS samples
+const int WAVETABLE_BITS = 8;
+const int WAVETABLE_SIZE = 1 << WAVETABLE_BITS;
+// XO-CHIP audio pattern buffer: 128 1-bit samples played at PATTERN_RATE Hz for pitch 64
+const int PATTERN_BITS = 7;
+const double PATTERN_RATE = 4000.0;
+
+/**
+ * Audio device measurements, in milliseconds.
+ */
+struct AudioStats {
+  int sample_rate;
+  int buffer_samples;
+  unsigned long callbacks;
+  // Callbacks arriving more than a buffer late, the device ran out of samples
+  unsigned long underruns;
+  // Deviation of the callback period from the buffer duration
+  double mean_jitter;
+  double max_jitter;
+  // Time from an ST write starting a beep to the first sample of the tone
+  unsigned long beeps;
+  double mean_onset_latency;
+  double max_onset_latency;
+};
 
-class Interface {
+/**
+ * SDL window, keyboard and audio device.
+ */
+class Interface : public Frontend {
 public:
-  Interface(const std::shared_ptr<reg::RegisterManager> & registers, bool hidden = false);
-  virtual ~Interface();
+  Interface(const std::shared_ptr<reg::RegisterManager> & registers, bool hidden = false,
+            int sample_rate = SAMPLE_RATE, int buffer_samples = AUDIO_BUFFER_SAMPLES);
+  ~Interface() override;
 
   /**
-   * Polls SDL events
+   * Drains all pending SDL events, updating the input keys and the close request.
    */
   void poll_events();
 
+  /**
+   * Blocks until an SDL event arrives or the timeout expires, then drains all pending events.
+   * @param timeout in milliseconds
+   */
+  void wait_events(int timeout);
+
   /**
    * @returns The user requested the window to close.
    */
   bool requests_close() const;
 
   /**
-   * clears screen
+   * Maps the keyboard to the keypad.
+   * @param layout SDL names of the keys bound to the keypad keys 0 to F, one character each.
+   * @throws std::runtime_error if the layout is invalid or binds a key twice
    */
-  void clear();
+  void set_keymap(const std::string & layout);
 
   /**
-   * Set a pixel to an on/off state in the screen memory.
-   * @param x
-   * @param y
-   * @param on
+   * Uploads a frame buffer to the window. Must be called from the thread handling the events.
+   * @param display
    */
-  void set_pixel_state(unsigned short int x, unsigned short int y, bool on);
+  void present(const Display & display);
 
   /**
-   * Prints screen memory to display.
+   * @returns Mask of the keypad keys held down on the keyboard, updated by the events.
    */
-  void render();
+  uint16_t get_input() const;
 
   /**
-   * Returns given pixel state from screen memory.
-   * @param x
-   * @param y
-   * @return
+   * Toggles the buzzer based on the sound timer value.
+   * The audio device is only touched when the buzzer starts or stops.
+   * Once the program loaded an XO-CHIP audio pattern, the pattern and its pitch are published to
+   * the audio thread as well.
    */
-  bool is_pixel_on(int x, int y);
+  void toogle_buzzer();
 
   /**
-   * Update pressed keys vector.
+   * @param pitch XO-CHIP pitch register.
+   * @param sample_rate
+   * @returns The 32-bit fixed point step in the pattern buffer between two output samples.
    */
-  void get_keys();
+  static uint32_t get_pattern_increment(uint8_t pitch, int sample_rate);
 
   /**
-   * @param key
-   * @return Is the key pressed.
+   * @returns The buzzer is sounding.
    */
-  bool is_pressed(uint8_t key) const;
+  bool is_buzzing() const;
 
   /**
-   * @return The pressed key. If none returns 0x10.
+   * Records the time of an ST write that starts a beep, to measure the beep onset latency.
    */
-  uint8_t get_any_pressed() const;
+  void mark_beep_request() override;
 
   /**
-   * Toggles the buzzer based on the sound timer value.
+   * @returns The audio device measurements.
    */
-  void toogle_buzzer();
+  AudioStats get_audio_stats() const;
 
-  const unsigned short int SIZE_X_ = 64;
-  const unsigned short int SIZE_Y_ = 32;
+  // Size of a low resolution pixel in the window
   const unsigned short int SIZE_MULTIPLIER_ = 20;
 
-  int sample_length_ = 0;
-  std::vector<std::vector<bool>> screen_memory_ =
-          std::vector<std::vector<bool>>(SIZE_X_, std::vector<bool>(SIZE_Y_, false));
-
-  /**
-   * For testing/debugging
-   * @param key
-   */
-  static void simulate_keypress(SDL_Keycode key);
-
 private:
-  const Uint8 * key_state_;
+  // Keypad key bound to each scancode, 0x10 when unbound
+  std::array<uint8_t, SDL_NUM_SCANCODES> keymap_;
+  bool close_requested_ = false;
+  // Keys held down on the keyboard, only used by the thread handling the events
+  Keypad input_;
   std::shared_ptr<reg::RegisterManager> registers_;
+  // A hidden window is never presented, so it is not rendered either
+  bool hidden_;
   SDL_Window * window = nullptr;
   SDL_Renderer * renderer = nullptr;
-  int bpp_;
+  SDL_Texture * texture_ = nullptr;
   SDL_Event events_;
-  Uint8 * p_;
   SDL_AudioSpec want_, have_;
-  int sound_userdata_ = 0;
-  Sint16 * audio_buffer_ = nullptr;
+  SDL_AudioDeviceID audio_device_ = 0;
+
+  // Band-limited square wave, read by the audio thread
+  std::array<Sint16, WAVETABLE_SIZE> wavetable_;
+  // 32-bit fixed point position in the wavetable, only used by the audio thread
+  uint32_t phase_ = 0;
+  uint32_t phase_increment_ = 0;
+  // Written by the emulation, read by the audio thread
+  std::atomic<bool> buzzer_on_{false};
+
+  // XO-CHIP pattern buffer as 2 big-endian words, written by the emulation, read by the audio
+  // thread. A pattern change may be heard half applied for one buffer.
+  std::array<std::atomic<uint64_t>, 2> pattern_{};
+  std::atomic<bool> pattern_on_{false};
+  std::atomic<uint32_t> pattern_increment_{0};
+  // Pitch pattern_increment_ was computed for, only used by the emulation
+  int pattern_pitch_ = -1;
+  // 32-bit fixed point position in the pattern buffer, only used by the audio thread
+  uint32_t pattern_phase_ = 0;
+  // Incremented each time the device is resumed, so the pause is not measured as jitter
+  std::atomic<unsigned long> audio_epoch_{0};
+  std::atomic<Uint64> beep_requested_at_{0};
+
+  // Measurements, written by the audio thread only
+  unsigned long callback_epoch_ = 0;
+  Uint64 last_callback_ = 0;
+  Uint64 buffer_period_ = 0;
+  std::atomic<unsigned long> callbacks_{0}, underruns_{0}, jitter_count_{0}, beeps_{0};
+  std::atomic<Uint64> jitter_sum_{0}, jitter_max_{0}, onset_sum_{0}, onset_max_{0};
+
+  /**
+   * Applies an SDL event to the keypad and the close request.
+   * @param event
+   */
+  void handle_event(const SDL_Event & event);
+
+  /**
+   * Precomputes one period of the buzzer tone for the given sample rate, keeping only the
+   * harmonics of the square wave below the Nyquist frequency.
+   * @param sample_rate
+   */
+  void build_wavetable(int sample_rate);
 
   /**
-   * Normalizes x coordinates given the size of the window.
-   * @param x
-   * @return
+   * Opens the audio device, logging and leaving the buzzer silent on failure.
+   * @param sample_rate
+   * @param buffer_samples
    */
-  unsigned short int normalize_x(unsigned short int x) const;
+  void open_audio(int sample_rate, int buffer_samples);
 
   /**
-   * Normalizes y coordinates given the size of the window.
-   * @param y
-   * @return
+   * Publishes the XO-CHIP pattern buffer and pitch registers to the audio thread.
    */
-  unsigned short int normalize_y(unsigned short int y) const;
+  void update_pattern();
+
+  /**
+   * Updates the callback period measurements.
+   * @param now Performance counter at the start of the callback.
+   */
+  void measure_callback(Uint64 now);
 
   /**
    * Audio callback that SDL uses to fill the audio buffer.
-   * @param user_data
    * @param raw_buffer
    * @param bytes
    */
-  void audio_callback(void * user_data, Uint8 * raw_buffer, int bytes);
+  void audio_callback(Uint8 * raw_buffer, int bytes);
 
   /**
    * Static forward function used as callback. Calls audio_callback.
-   * @param userdata
+   * @param userdata The Interface
    * @param stream
    * @param len
    */
   static void forward_audio_callback(void * userdata, Uint8 * stream, int len);
-
-  /**
-   * Draws one pixel on the display.
-   * @param x
-   * @param y
-   * @param state
-   */
-  void draw_pixel(unsigned short x, unsigned short y, bool state);
 };
 
 
@@ -4,6 +4,7 @@
 #ifndef CHIP8_INTERPRETER_H
 #define CHIP8_INTERPRETER_H
 
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <iostream>
@@ -11,24 +12,95 @@
 #include <thread>
 
 #include "Configuration.h"
-#include "Instructions.h"
+#include "FrameExport.h"
+#include "FramePacer.h"
 #include "Interface.h"
-#include "Memory.h"
-#include "RomParser.h"
-#include "register/RegisterManager.h"
+#include "Machine.h"
+#include "SpscQueue.h"
+#include "VideoWriter.h"
 
+/**
+ * Message from the SDL thread to the emulation thread.
+ */
+struct Input {
+  // Keypad keys held down
+  uint16_t keys;
+  bool quit;
+};
+
+/**
+ * Message from the emulation thread to the SDL thread.
+ */
+struct Frame {
+  Display display;
+  // The program exited, this is the last frame
+  bool exited;
+};
+
+/**
+ * Runs the emulation on its own thread, the calling thread handling SDL. They only communicate
+ * through lock-free queues, so a slow present or a window drag never delays the emulation.
+ */
 class Interpreter {
 public:
   Interpreter(std::shared_ptr<Configuration> configuration);
+
+  /**
+   * Starts the emulation thread, then handles the events and presents the frames until the
+   * window is closed or the program exits.
+   */
   void loop();
 
 private:
   std::shared_ptr<Configuration> configuration_;
-  std::shared_ptr<mem::Memory> memory_;
   std::shared_ptr<reg::RegisterManager> registers_;
-  std::shared_ptr<Instructions> instructions_;
   std::shared_ptr<Interface> interface_;
-  std::shared_ptr<RomParser> romParser_;
+  Machine machine_;
+
+  SpscQueue<Input, 16> inputs_;
+  SpscQueue<Frame, 4> frames_;
+  // Last frame received, only used by the SDL thread
+  Frame frame_{};
+  // Frames received while a newer one was waiting, only used by the SDL thread
+  unsigned long superseded_frames_ = 0;
+  // Only used by the emulation thread
+  FramePacer pacer_;
+  // Publishes every frame to shared memory, if configured. Only used by the emulation thread
+  std::unique_ptr<FrameExport> export_;
+  // Records every frame, if configured. Only pushed to by the emulation thread
+  std::unique_ptr<VideoWriter> video_;
+
+  /**
+   * Emulation thread: runs the CPU in real time, one timer period per iteration, applies the
+   * keys received and publishes the frame buffer when it changed. With run-ahead, the frame
+   * published is the one a few periods later, if the keys stay the same.
+   */
+  void run_core();
+
+  /**
+   * Prints the audio device measurements, if the buzzer was used.
+   */
+  void print_audio_stats() const;
+
+  /**
+   * Prints the number of dispatches and of each superinstruction.
+   */
+  void print_fusion_stats() const;
+
+  /**
+   * Prints the last fault and the address of the instruction that raised it.
+   */
+  void print_fault() const;
+
+  /**
+   * Prints the frame pacing counters, if the host fell behind.
+   */
+  void print_frame_stats() const;
+
+  /**
+   * Prints the number of video frames written and dropped, if recording.
+   */
+  void print_video_stats() const;
 };
 
 
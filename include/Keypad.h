@@ -0,0 +1,54 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_KEYPAD_H
+#define CHIP8_KEYPAD_H
+
+#include <cstdint>
+#include <string>
+
+// Keyboard keys bound to the keypad keys 0 to F
+const std::string DEFAULT_KEYMAP = "X123QWEASDZC4RFV";
+
+/**
+ * State of the 16 keys hexadecimal keypad, one bit per key.
+ */
+class Keypad {
+public:
+  /**
+   * @param key
+   * @return Is the key pressed.
+   */
+  bool is_pressed(uint8_t key) const;
+
+  /**
+   * @return The lowest pressed key. If none returns 0x10.
+   */
+  uint8_t get_any_pressed() const;
+
+  /**
+   * @param key
+   */
+  void press(uint8_t key);
+
+  /**
+   * @param key
+   */
+  void release(uint8_t key);
+
+  /**
+   * @returns The state of the keypad, bit n is set when key n is pressed.
+   */
+  uint16_t get_mask() const;
+
+  /**
+   * @param mask The state of the keypad, bit n is set when key n is pressed.
+   */
+  void set_mask(uint16_t mask);
+
+private:
+  uint16_t mask_ = 0x0;
+};
+
+
+#endif//CHIP8_KEYPAD_H
@@ -0,0 +1,116 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_LANEGROUP_H
+#define CHIP8_LANEGROUP_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Machine.h"
+#include "Opcodes.h"
+
+/**
+ * Lane-wise execution counters.
+ */
+struct LaneStats {
+  // Instructions executed once for several lanes
+  unsigned long vector;
+  // Lanes those instructions ran for
+  unsigned long lanes;
+  // Instructions run by the scalar interpreter of a lane
+  unsigned long scalar;
+};
+
+/**
+ * Runs up to LANES machines of the same ROM together, one lane each. The V registers, I and PC of
+ * every lane are kept in vectors, register n of all the lanes filling one SIMD register.
+ * At each instruction, the lanes at the lowest PC run it at once, the others being masked out
+ * until the lagging lanes catch up. Only instructions that touch nothing but V, I and PC run
+ * lane-wise: the others, and lanes whose memory holds another opcode, go through the scalar
+ * interpreter of each machine, one instruction at a time. Timers are accounted for afterwards,
+ * since these instructions do not read them, so every lane ends in exactly the state the scalar
+ * interpreter would leave it in.
+ */
+class LaneGroup {
+public:
+  static constexpr unsigned int LANES = 16;
+
+  // One byte or word per lane, mapped to SSE or AVX registers by the compiler
+  using bytes_t = uint8_t __attribute__((vector_size(LANES)));
+  using words_t = uint16_t __attribute__((vector_size(LANES * 2)));
+
+  /**
+   * @param machines Up to LANES machines sharing one configuration.
+   */
+  explicit LaneGroup(const std::vector<Machine *> & machines);
+
+  /**
+   * Runs every lane up to its next timer tick, as RomParser::run() would.
+   */
+  void run_frame();
+
+  const LaneStats & get_stats() const;
+
+private:
+  std::vector<Machine *> machines_;
+  std::array<const mem::Memory *, LANES> memories_{};
+  std::array<bytes_t, 0x10> v_{};
+  words_t i_{};
+  words_t pc_{};
+  // Cycles left in the frame, and cycles run lane-wise since the lane was last written back
+  std::array<unsigned int, LANES> remaining_{};
+  std::array<unsigned int, LANES> used_{};
+  bool shift_sets_vy_;
+  bool logic_resets_vf_;
+  bool jump_uses_vx_;
+  LaneStats stats_{};
+
+  /**
+   * Copies the registers of a machine to its lane.
+   * @param lane
+   */
+  void gather(unsigned int lane);
+
+  /**
+   * Writes the lane back to its machine, and runs its timers for the cycles used lane-wise.
+   * @param lane
+   */
+  void scatter(unsigned int lane);
+
+  /**
+   * Takes a lane out of the frame if its machine exited or stopped on a fault. A lane waiting for
+   * a key runs the rest of its frame through its interpreter, which handles Fx0A.
+   * @param lane
+   */
+  void settle(unsigned int lane);
+
+  /**
+   * Runs the next instruction of a lane through its interpreter.
+   * @param lane
+   */
+  void run_scalar(unsigned int lane);
+
+  /**
+   * @param opcode
+   * @returns The instruction only touches V, I and PC.
+   */
+  static bool is_lane_wise(op::opcode_t opcode);
+
+  /**
+   * Runs an instruction for the lanes of a mask, their PC pointing at it.
+   * @param opcode
+   * @param mask 0xFF for the lanes that run it.
+   */
+  void execute(op::opcode_t opcode, bytes_t mask);
+
+  /**
+   * Skips the next instruction in the lanes of a mask, 4 bytes for F000 NNNN.
+   * @param mask
+   */
+  void skip_next(bytes_t mask);
+};
+
+
+#endif//CHIP8_LANEGROUP_H
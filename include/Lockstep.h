@@ -0,0 +1,121 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_LOCKSTEP_H
+#define CHIP8_LOCKSTEP_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Configuration.h"
+#include "Machine.h"
+
+/**
+ * Everything that makes the state of a machine, memory and frame buffer as digests.
+ */
+struct MachineState {
+  std::array<uint8_t, 0x10> v;
+  uint16_t i;
+  uint16_t pc;
+  uint8_t dt;
+  uint8_t st;
+  // Bottom first
+  std::vector<uint16_t> stack;
+  std::array<uint8_t, 0x10> rpl;
+  bool halted;
+  bool exited;
+  Fault fault;
+  bool faulted;
+  bool hires;
+  uint8_t planes;
+  uint64_t memory_digest;
+  uint64_t display_digest;
+
+  /**
+   * @param machine
+   * @returns The current state of the machine.
+   */
+  static MachineState capture(const Machine & machine);
+
+  /**
+   * @param other
+   * @returns One line per field that differs, "name: this != other", empty if the states match.
+   */
+  std::string diff(const MachineState & other) const;
+};
+
+/**
+ * Differential testing: runs the reference core, step() and decode() only, side by side with the
+ * core the configuration selects (superinstructions, idle loop skipping, native code) on the same
+ * ROM, seed and keys. The full states are compared every interval cycles, and the run stops at
+ * the first divergence.
+ * A superinstruction or native block never crosses an interval boundary, so an interval of 1
+ * checks every instruction but only exercises the decoder of the candidate core.
+ */
+class Lockstep {
+public:
+  /**
+   * @param configuration Candidate core. Both machines use its seed, or the same random one.
+   */
+  explicit Lockstep(const std::shared_ptr<Configuration> & configuration);
+
+  /**
+   * Runs both machines until cycles elapsed, or they diverge, or the program exits or stops on a
+   * fault.
+   * @param cycles
+   * @param interval Cycles between two comparisons.
+   * @returns The number of cycles run without divergence.
+   * @throws std::runtime_error if interval is 0
+   */
+  unsigned long run(unsigned long cycles, unsigned int interval = 1);
+
+  /**
+   * Presses a key on both keypads.
+   * @param key
+   */
+  void press(uint8_t key);
+
+  /**
+   * Releases a key on both keypads.
+   * @param key
+   */
+  void release(uint8_t key);
+
+  /**
+   * @returns The machines diverged.
+   */
+  bool has_diverged() const;
+
+  /**
+   * @returns Where the machines diverged and the state diff, reference first, empty if they did
+   * not.
+   */
+  const std::string & get_report() const;
+
+  const Machine & get_reference() const;
+  const Machine & get_candidate() const;
+
+private:
+  Machine reference_;
+  Machine candidate_;
+  unsigned long cycles_ = 0;
+  std::string report_;
+
+  /**
+   * @param configuration
+   * @returns The reference core configuration, same ROM, quirks and seed as configuration.
+   */
+  static std::shared_ptr<Configuration>
+  make_reference(const std::shared_ptr<Configuration> & configuration);
+
+  /**
+   * Appends the first memory address and frame buffer row that differ to the report.
+   */
+  void locate_divergence();
+};
+
+
+#endif//CHIP8_LOCKSTEP_H
@@ -0,0 +1,88 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_MACHINE_H
+#define CHIP8_MACHINE_H
+
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "Configuration.h"
+#include "Display.h"
+#include "Frontend.h"
+#include "Instructions.h"
+#include "Memory.h"
+#include "RomParser.h"
+#include "register/RegisterManager.h"
+
+/**
+ * Complete copy of a machine state, restored in place without reconstructing the components.
+ * The memory pages are shared with the machine until it writes to them.
+ */
+struct Snapshot {
+  mem::image_t memory;
+  reg::RegisterManager registers;
+  Display display;
+  uint16_t keys;
+  std::mt19937 random;
+};
+
+/**
+ * Machine owning every component, headless unless given a frontend.
+ */
+struct Machine {
+  /**
+   * @param configuration
+   * @param load_rom Loads the configured ROM, otherwise the memory is left empty.
+   */
+  explicit Machine(const std::shared_ptr<Configuration> & configuration, bool load_rom = true);
+
+  /**
+   * @param configuration
+   * @param registers Registers the frontend was built with.
+   * @param interface
+   * @param load_rom
+   */
+  Machine(const std::shared_ptr<Configuration> & configuration,
+          const std::shared_ptr<reg::RegisterManager> & registers,
+          const std::shared_ptr<Frontend> & interface, bool load_rom = true);
+
+  std::shared_ptr<Configuration> configuration_;
+  std::shared_ptr<mem::Memory> memory_;
+  std::shared_ptr<reg::RegisterManager> registers_;
+  std::shared_ptr<Frontend> interface_;
+  std::shared_ptr<Instructions> instructions_;
+  std::shared_ptr<RomParser> romParser_;
+
+  /**
+   * @returns The current state.
+   */
+  Snapshot save() const;
+
+  /**
+   * Brings the machine back to a saved state. Native code disabled by self-modifying code stays
+   * disabled.
+   * @param snapshot
+   */
+  void restore(const Snapshot & snapshot);
+
+  /**
+   * Runs frames ahead of the current state with the keys currently held, then restores it. Each
+   * frame runs the CPU up to the next timer tick. The sound and the faults of these frames are
+   * discarded with them: they neither request beeps nor trap to the debugger.
+   * @param frames
+   * @returns The display once these frames ran.
+   */
+  Display run_ahead(unsigned int frames);
+
+  /**
+   * @returns Fingerprint of the memory, the registers, the frame buffer and the keys, in constant
+   * time: the memory and the frame buffer keep theirs up to date as they are written. The state of
+   * the random number generator is left out.
+   */
+  uint64_t get_hash() const;
+};
+
+
+#endif//CHIP8_MACHINE_H
@@ -8,15 +8,51 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
+#ifndef CHIP8_MEMORY_SIZE
+// 0x1000 for CHIP-8 and SUPER-CHIP, 0x10000 for XO-CHIP
+#define CHIP8_MEMORY_SIZE 0x1000
+#endif
+
 namespace mem {
   using address_t = short unsigned int;
 
+  const unsigned int MEMORY_SIZE = CHIP8_MEMORY_SIZE;
+  static_assert(MEMORY_SIZE >= 0x1000 && MEMORY_SIZE <= 0x10000,
+                "Memory size must be between 4 KB and 64 KB");
+
+  // Unit of sharing between memories
+  const unsigned int PAGE_SIZE = 0x100;
+  const unsigned int PAGES = MEMORY_SIZE / PAGE_SIZE;
+
+  /**
+   * A page and its fingerprint, the sum of the fingerprints of its bytes, shared along with it.
+   */
+  struct page_t {
+    std::array<uint8_t, PAGE_SIZE> bytes;
+    uint64_t hash;
+  };
+
+  /**
+   * The whole memory as pages, which copies share. A shared page is never written: the memory
+   * writing it first makes its own copy.
+   */
+  using image_t = std::array<std::shared_ptr<page_t>, PAGES>;
+
+  /**
+   * Copy-on-write memory. Every memory starts from the same font and zero pages, and a page only
+   * gets private to a memory when it writes to it while it is shared, so instances of a ROM
+   * loaded from the same image share its pages until they modify them.
+   */
   class Memory {
   public:
-    const std::vector<uint8_t> FONT_ = {
+    // Pre loaded sprites of the digits, at 0x000 in the boot image
+    // http://devernay.free.fr/hacks/chip8/C8TECH10.HTM#font
+    static constexpr std::array<uint8_t, 80> FONT_ = {
             0xF0, 0x90, 0x90, 0x90, 0xF0, 0x20, 0x60, 0x20, 0x20, 0x70, 0xF0, 0x10, 0xF0, 0x80,
             0xF0, 0xF0, 0x10, 0xF0, 0x10, 0xF0, 0x90, 0x90, 0xF0, 0x10, 0x10, 0xF0, 0x80, 0xF0,
             0x10, 0xF0, 0xF0, 0x80, 0xF0, 0x90, 0xF0, 0xF0, 0x10, 0x20, 0x40, 0x40, 0xF0, 0x90,
@@ -24,6 +60,21 @@ namespace mem {
             0x90, 0xE0, 0x90, 0xE0, 0xF0, 0x80, 0x80, 0x80, 0xF0, 0xE0, 0x90, 0x90, 0x90, 0xE0,
             0xF0, 0x80, 0xF0, 0x80, 0xF0, 0xF0, 0x80, 0xF0, 0x80, 0x80};
 
+    // SUPER-CHIP 8x10 digits, stored right after FONT_
+    static constexpr std::array<uint8_t, 160> BIG_FONT_ = {
+            0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x18, 0x78, 0x78, 0x18,
+            0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0xC0, 0xC0,
+            0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0xC3, 0xC3,
+            0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0x03, 0x03, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF,
+            0x03, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF,
+            0xFF, 0xFF, 0x03, 0x03, 0x06, 0x0C, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF, 0xC3, 0xC3,
+            0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03,
+            0xFF, 0xFF, 0x7E, 0xFF, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xFC, 0xFC,
+            0xC3, 0xC3, 0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, 0x3C, 0xFF, 0xC3, 0xC0, 0xC0, 0xC0,
+            0xC0, 0xC3, 0xFF, 0x3C, 0xFC, 0xFE, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFE, 0xFC,
+            0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF, 0xC0, 0xC0,
+            0xFF, 0xFF, 0xC0, 0xC0, 0xC0, 0xC0};
+
     Memory();
 
     /**
@@ -45,21 +96,59 @@ namespace mem {
      * @param address
      * @return
      */
-    uint8_t peek(address_t address);
+    uint8_t peek(address_t address) const;
+
+    /**
+     * @returns The whole memory, for snapshots. Its pages are shared with the copies.
+     */
+    const image_t & get_image() const;
+
+    /**
+     * @brief Overwrites the whole memory, sharing the pages of image
+     * @param image
+     */
+    void set_image(const image_t & image);
 
     /**
-     * @brief Setup the pre loaded sprites http://devernay.free.fr/hacks/chip8/C8TECH10.HTM#font
-     * todo find a better place
+     * @returns The number of pages only this memory refers to.
      */
-    void init();
+    unsigned int get_private_pages() const;
+
+    /**
+     * @returns Fingerprint of the contents, updated by every poke.
+     */
+    uint64_t get_hash() const;
+
+    /**
+     * @param page
+     * @returns The fingerprint of the bytes of a page, computed from scratch.
+     */
+    static uint64_t hash_page(const page_t & page);
 
   private:
-    // The Chip-8 language is capable of accessing up to 4,096 bytes (0x1000) of RAM
-    std::array<uint8_t, 0x1000> memory_;
+    // The Chip-8 language is capable of accessing up to 4,096 bytes (0x1000) of RAM, XO-CHIP up
+    // to 65,536 bytes (0x10000)
+    image_t memory_;
+    // Sum of the fingerprints of the pages at their index
+    uint64_t hash_ = 0;
+
+    /**
+     * @param address
+     * @returns The page holding address, private to this memory.
+     */
+    page_t & get_writable(address_t address);
+
+    /**
+     * @param index
+     * @param page_hash
+     * @returns The fingerprint of a page at an index of the memory.
+     */
+    static uint64_t place(unsigned int index, uint64_t page_hash);
 
-    static inline void validate_address(address_t address) {
-      if (address < 0x000) { throw std::runtime_error("Memory address < 0x000 (0)"); }
-      if (address > 0xFFF) { throw std::runtime_error("Memory address > 0xFFF (4095)"); }
+    static inline void validate_address(unsigned int address) {
+      if (address >= MEMORY_SIZE) {
+        throw std::runtime_error("Memory address > " + std::to_string(MEMORY_SIZE - 1));
+      }
     }
 
     static inline void validate_value(uint8_t value) {
@@ -0,0 +1,62 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_NATIVECODE_H
+#define CHIP8_NATIVECODE_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "Aot.h"
+#include "Memory.h"
+
+/**
+ * ROM compiled ahead of time by CHIP8_AOT into a shared object.
+ */
+class NativeCode {
+public:
+  /**
+   * Loads the shared object.
+   * @param path
+   * @param rom_hash chip8_aot_hash() of the ROM being run.
+   * @throws std::runtime_error if the object cannot be loaded, or was compiled from another ROM or
+   * for another version of the interpreter
+   */
+  NativeCode(const std::string & path, uint64_t rom_hash);
+  virtual ~NativeCode();
+
+  NativeCode(const NativeCode &) = delete;
+  NativeCode & operator=(const NativeCode &) = delete;
+
+  /**
+   * Runs the compiled code, see chip8_aot_run_t.
+   * @param state
+   * @param max
+   * @returns The number of instructions executed.
+   */
+  unsigned int run(chip8_aot_state & state, unsigned int max) const;
+
+  /**
+   * @param address
+   * @param size
+   * @returns Compiled code is stored between address and address + size.
+   */
+  bool is_code(mem::address_t address, unsigned int size) const;
+
+private:
+  void * handle_ = nullptr;
+  chip8_aot_run_t run_ = nullptr;
+  const uint8_t * code_map_ = nullptr;
+  unsigned int code_map_size_ = 0;
+
+  /**
+   * @param name
+   * @returns The address of the symbol in the shared object.
+   * @throws std::runtime_error if the symbol is missing
+   */
+  void * find(const char * name) const;
+};
+
+
+#endif//CHIP8_NATIVECODE_H
@@ -0,0 +1,201 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_OPCODES_H
+#define CHIP8_OPCODES_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace op {
+  using opcode_t = uint16_t;
+
+  /**
+   * One handler per instruction, named after the Instructions method it calls.
+   */
+  enum class Handler : uint8_t {
+    unknown,
+    sys_0nnn,
+    cls_00E0,
+    ret_00EE,
+    scd_00Cn,
+    scu_00Dn,
+    scr_00FB,
+    scl_00FC,
+    exit_00FD,
+    low_00FE,
+    high_00FF,
+    jp_1nnn,
+    call_2nnn,
+    se_3xkk,
+    sne_4xkk,
+    se_5xy0,
+    ld_5xy2,
+    ld_5xy3,
+    ld_6xkk,
+    add_7xkk,
+    ld_8xy0,
+    or_8xy1,
+    and_8xy2,
+    xor_8xy3,
+    add_8xy4,
+    sub_8xy5,
+    shr_8xy6,
+    subn_8xy7,
+    shl_8xyE,
+    sne_9xy0,
+    ld_Annn,
+    jp_Bnnn,
+    rnd_Cxkk,
+    drw_Dxyn,
+    skp_Ex9E,
+    sknp_ExA1,
+    ld_F000,
+    plane_Fn01,
+    audio_F002,
+    ld_Fx07,
+    ld_Fx0A,
+    ld_Fx15,
+    ld_Fx18,
+    add_Fx1E,
+    ld_Fx29,
+    ld_Fx30,
+    ld_Fx33,
+    pitch_Fx3A,
+    ld_Fx55,
+    ld_Fx65,
+    ld_Fx75,
+    ld_Fx85,
+    count
+  };
+
+  /**
+   * Operands encoded in the opcode, in the order they appear in the mnemonic.
+   */
+  enum class Operands : uint8_t { none, nnn, xkk, xy, xyn, x, n, opcode };
+
+  struct Spec {
+    // Bits that identify the instruction, the others hold the operands
+    opcode_t pattern;
+    opcode_t mask;
+    Handler handler;
+    Operands operands;
+    // printf format taking the operands
+    const char * mnemonic;
+  };
+
+  /**
+   * Every instruction, indexed by handler. An opcode matching several patterns decodes to the
+   * last one, so the 0nnn catch-all comes before the 00xx instructions.
+   */
+  constexpr std::array<Spec, static_cast<size_t>(Handler::count)> SPEC = {{
+          {0x0000, 0x0000, Handler::unknown, Operands::opcode, "DW 0x%04X"},
+          {0x0000, 0xF000, Handler::sys_0nnn, Operands::nnn, "SYS 0x%03X"},
+          {0x00E0, 0xFFFF, Handler::cls_00E0, Operands::none, "CLS"},
+          {0x00EE, 0xFFFF, Handler::ret_00EE, Operands::none, "RET"},
+          {0x00C0, 0xFFF0, Handler::scd_00Cn, Operands::n, "SCD %u"},
+          {0x00D0, 0xFFF0, Handler::scu_00Dn, Operands::n, "SCU %u"},
+          {0x00FB, 0xFFFF, Handler::scr_00FB, Operands::none, "SCR"},
+          {0x00FC, 0xFFFF, Handler::scl_00FC, Operands::none, "SCL"},
+          {0x00FD, 0xFFFF, Handler::exit_00FD, Operands::none, "EXIT"},
+          {0x00FE, 0xFFFF, Handler::low_00FE, Operands::none, "LOW"},
+          {0x00FF, 0xFFFF, Handler::high_00FF, Operands::none, "HIGH"},
+          {0x1000, 0xF000, Handler::jp_1nnn, Operands::nnn, "JP 0x%03X"},
+          {0x2000, 0xF000, Handler::call_2nnn, Operands::nnn, "CALL 0x%03X"},
+          {0x3000, 0xF000, Handler::se_3xkk, Operands::xkk, "SE V%X, 0x%02X"},
+          {0x4000, 0xF000, Handler::sne_4xkk, Operands::xkk, "SNE V%X, 0x%02X"},
+          {0x5000, 0xF00F, Handler::se_5xy0, Operands::xy, "SE V%X, V%X"},
+          {0x5002, 0xF00F, Handler::ld_5xy2, Operands::xy, "LD [I], V%X - V%X"},
+          {0x5003, 0xF00F, Handler::ld_5xy3, Operands::xy, "LD V%X - V%X, [I]"},
+          {0x6000, 0xF000, Handler::ld_6xkk, Operands::xkk, "LD V%X, 0x%02X"},
+          {0x7000, 0xF000, Handler::add_7xkk, Operands::xkk, "ADD V%X, 0x%02X"},
+          {0x8000, 0xF00F, Handler::ld_8xy0, Operands::xy, "LD V%X, V%X"},
+          {0x8001, 0xF00F, Handler::or_8xy1, Operands::xy, "OR V%X, V%X"},
+          {0x8002, 0xF00F, Handler::and_8xy2, Operands::xy, "AND V%X, V%X"},
+          {0x8003, 0xF00F, Handler::xor_8xy3, Operands::xy, "XOR V%X, V%X"},
+          {0x8004, 0xF00F, Handler::add_8xy4, Operands::xy, "ADD V%X, V%X"},
+          {0x8005, 0xF00F, Handler::sub_8xy5, Operands::xy, "SUB V%X, V%X"},
+          {0x8006, 0xF00F, Handler::shr_8xy6, Operands::xy, "SHR V%X, V%X"},
+          {0x8007, 0xF00F, Handler::subn_8xy7, Operands::xy, "SUBN V%X, V%X"},
+          {0x800E, 0xF00F, Handler::shl_8xyE, Operands::xy, "SHL V%X, V%X"},
+          {0x9000, 0xF00F, Handler::sne_9xy0, Operands::xy, "SNE V%X, V%X"},
+          {0xA000, 0xF000, Handler::ld_Annn, Operands::nnn, "LD I, 0x%03X"},
+          {0xB000, 0xF000, Handler::jp_Bnnn, Operands::nnn, "JP V0, 0x%03X"},
+          {0xC000, 0xF000, Handler::rnd_Cxkk, Operands::xkk, "RND V%X, 0x%02X"},
+          {0xD000, 0xF000, Handler::drw_Dxyn, Operands::xyn, "DRW V%X, V%X, %u"},
+          {0xE09E, 0xF0FF, Handler::skp_Ex9E, Operands::x, "SKP V%X"},
+          {0xE0A1, 0xF0FF, Handler::sknp_ExA1, Operands::x, "SKNP V%X"},
+          {0xF000, 0xFFFF, Handler::ld_F000, Operands::none, "LD I, long"},
+          {0xF001, 0xF0FF, Handler::plane_Fn01, Operands::x, "PLANE %u"},
+          {0xF002, 0xFFFF, Handler::audio_F002, Operands::none, "AUDIO"},
+          {0xF007, 0xF0FF, Handler::ld_Fx07, Operands::x, "LD V%X, DT"},
+          {0xF00A, 0xF0FF, Handler::ld_Fx0A, Operands::x, "LD V%X, K"},
+          {0xF015, 0xF0FF, Handler::ld_Fx15, Operands::x, "LD DT, V%X"},
+          {0xF018, 0xF0FF, Handler::ld_Fx18, Operands::x, "LD ST, V%X"},
+          {0xF01E, 0xF0FF, Handler::add_Fx1E, Operands::x, "ADD I, V%X"},
+          {0xF029, 0xF0FF, Handler::ld_Fx29, Operands::x, "LD F, V%X"},
+          {0xF030, 0xF0FF, Handler::ld_Fx30, Operands::x, "LD HF, V%X"},
+          {0xF033, 0xF0FF, Handler::ld_Fx33, Operands::x, "LD B, V%X"},
+          {0xF03A, 0xF0FF, Handler::pitch_Fx3A, Operands::x, "PITCH V%X"},
+          {0xF055, 0xF0FF, Handler::ld_Fx55, Operands::x, "LD [I], V%X"},
+          {0xF065, 0xF0FF, Handler::ld_Fx65, Operands::x, "LD V%X, [I]"},
+          {0xF075, 0xF0FF, Handler::ld_Fx75, Operands::x, "LD R, V%X"},
+          {0xF085, 0xF0FF, Handler::ld_Fx85, Operands::x, "LD V%X, R"},
+  }};
+
+  /**
+   * Handler of each of the 65,536 opcodes, generated at compile time from SPEC.
+   */
+  extern const std::array<Handler, 0x10000> TABLE;
+
+  /**
+   * @param opcode
+   * @returns The instruction the opcode decodes to.
+   */
+  inline const Spec & get_spec(opcode_t opcode) {
+    return SPEC[static_cast<size_t>(TABLE[opcode])];
+  }
+
+  /**
+   * Instruction sequences frequent in ROMs, dispatched as one superinstruction.
+   */
+  enum class Fusion : uint8_t {
+    ld_drw_Annn_Dxyn,
+    ld_ld_6xkk_Fx15,
+    add_se_7xkk_3xkk,
+    add_sne_7xkk_4xkk,
+    ld_se_jp_Fx07_3xkk_1nnn,
+    count
+  };
+
+  constexpr std::array<const char *, static_cast<size_t>(Fusion::count)> FUSION_NAMES = {
+          "Annn Dxyn", "6xkk Fx15", "7xkk 3xkk", "7xkk 4xkk", "Fx07 3xkk 1nnn"};
+
+  /**
+   * Operands extraction.
+   */
+  constexpr uint8_t x(opcode_t opcode) {
+    return (opcode >> 8) & 0xF;
+  }
+  constexpr uint8_t y(opcode_t opcode) {
+    return (opcode >> 4) & 0xF;
+  }
+  constexpr uint8_t n(opcode_t opcode) {
+    return opcode & 0xF;
+  }
+  constexpr uint8_t kk(opcode_t opcode) {
+    return opcode & 0xFF;
+  }
+  constexpr uint16_t nnn(opcode_t opcode) {
+    return opcode & 0xFFF;
+  }
+
+  /**
+   * @param opcode
+   * @returns The assembly of the opcode, e.g. "DRW V1, V2, 5".
+   */
+  std::string disassemble(opcode_t opcode);
+}// namespace op
+
+#endif//CHIP8_OPCODES_H
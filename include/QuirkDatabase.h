@@ -0,0 +1,108 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_QUIRKDATABASE_H
+#define CHIP8_QUIRKDATABASE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "Configuration.h"
+
+// Quirk database the interpreter reads when no quirk switch is given
+const std::string DEFAULT_QUIRK_DATABASE = "chip8_quirks.txt";
+
+namespace quirk {
+  // Bit n - 1 stands for the command line switch -n
+  const unsigned int SHIFT_SETS_VY = 0x1;
+  const unsigned int JUMP_USES_VX = 0x2;
+  const unsigned int LOAD_STORE_INCREMENTS_I = 0x4;
+  const unsigned int LOGIC_RESETS_VF = 0x8;
+  const unsigned int COMBINATIONS = 0x10;
+
+  /**
+   * @param rom_path
+   * @param frequency
+   * @param quirks Quirk flags.
+   * @returns A configuration with these quirks, the other settings left to their default.
+   */
+  std::shared_ptr<Configuration> make_configuration(const std::string & rom_path, int frequency,
+                                                    unsigned int quirks);
+
+  /**
+   * @param configuration
+   * @returns The quirk flags of a configuration.
+   */
+  unsigned int get_quirks(const Configuration & configuration);
+
+  /**
+   * @param quirks
+   * @returns The switch of each quirk, or '-' if it is off: "1--4" for -1 -4.
+   */
+  std::string format(unsigned int quirks);
+
+  /**
+   * @param text As written by format().
+   * @returns The quirk flags.
+   * @throws std::runtime_error if text is not 4 switches or '-'
+   */
+  unsigned int parse(const std::string & text);
+}// namespace quirk
+
+/**
+ * Quirks each ROM runs with, found by CHIP8_QUIRKS and indexed by ROM hash. The file holds one ROM
+ * per line: its chip8_aot_hash() in hexadecimal, its quirks as quirk::format() writes them, and
+ * the ROM name. Lines starting with '#' are comments.
+ */
+class QuirkDatabase {
+public:
+  /**
+   * Loads the database, if the file exists.
+   * @param path
+   * @throws std::runtime_error if a line is malformed
+   */
+  explicit QuirkDatabase(const std::string & path);
+
+  /**
+   * @param rom_hash
+   * @returns The quirks of the ROM, if it is in the database.
+   */
+  std::optional<unsigned int> find(uint64_t rom_hash) const;
+
+  /**
+   * @param rom_path
+   * @returns The quirks of the ROM file, if it can be read and is in the database.
+   */
+  std::optional<unsigned int> find_rom(const std::string & rom_path) const;
+
+  /**
+   * Adds a ROM, or replaces its quirks.
+   * @param rom_hash
+   * @param quirks
+   * @param name
+   */
+  void set(uint64_t rom_hash, unsigned int quirks, const std::string & name);
+
+  /**
+   * Writes the database back to its file.
+   * @throws std::runtime_error if the file cannot be written
+   */
+  void save() const;
+
+  size_t size() const;
+
+private:
+  struct Entry {
+    unsigned int quirks;
+    std::string name;
+  };
+
+  std::string path_;
+  std::map<uint64_t, Entry> entries_;
+};
+
+
+#endif//CHIP8_QUIRKDATABASE_H
@@ -0,0 +1,123 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_QUIRKSWEEP_H
+#define CHIP8_QUIRKSWEEP_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Fault.h"
+#include "QuirkDatabase.h"
+
+/**
+ * How a run under one quirk combination ended.
+ */
+enum class Outcome : uint8_t {
+  // Ran the whole cycle budget
+  completed,
+  // The program exited with 00FD
+  exited,
+  // The program stopped on a fault
+  faulted,
+  // The state stopped changing from one frame to the next
+  stalled,
+  count
+};
+
+constexpr std::array<const char *, static_cast<size_t>(Outcome::count)> OUTCOME_NAMES = {
+        "completed", "exited", "faulted", "stalled"};
+
+struct QuirkResult {
+  unsigned int quirks;
+  Outcome outcome;
+  // Cycles run until the outcome
+  unsigned long cycles;
+  Fault fault;
+  // Digest of the last frame
+  uint64_t display_digest;
+  // Ends on another frame than the expected combination, see QuirkSweep
+  bool diverged;
+  // First frame whose display differs from the expected combination
+  unsigned long divergence_frame;
+};
+
+/**
+ * Runs a ROM headless under the 16 quirk combinations, in parallel, with the same seed and keys.
+ * Keys are pressed at random every half second, so the ROMs waiting for one get going.
+ * Among the combinations that do not fault, the last frame most of them agree on is the expected
+ * one. Stalled combinations count with the frame they stalled on, as test ROMs draw their results
+ * then jump to themselves. The combinations ending on another frame diverge, and the one with the
+ * fewest quirks among those that do not is recommended. When several frames are reached by as many
+ * combinations, the sweep is ambiguous and nothing is recommended.
+ */
+class QuirkSweep {
+public:
+  // Frames the state must stay the same for a run to stall
+  static const unsigned int STALL_FRAMES = 120;
+
+  /**
+   * @param rom
+   * @param frequency
+   * @param seed Seed of the random numbers and keys, shared by all the combinations.
+   * @throws std::runtime_error if the ROM does not fit in memory
+   */
+  QuirkSweep(const std::vector<uint8_t> & rom, int frequency, unsigned int seed = 1);
+
+  /**
+   * Runs every combination for a cycle budget.
+   * @param cycles
+   * @param threads Combinations run at once.
+   */
+  void run(unsigned long cycles, unsigned int threads);
+
+  /**
+   * @returns One result per combination, indexed by quirks.
+   */
+  const std::vector<QuirkResult> & get_results() const;
+
+  /**
+   * @returns The recommended quirks, none if every combination faulted or the sweep is ambiguous.
+   */
+  std::optional<unsigned int> get_recommended() const;
+
+  /**
+   * @returns Whether the most common last frames are tied, leaving no frame expected.
+   */
+  bool is_ambiguous() const;
+
+  uint64_t get_rom_hash() const;
+
+private:
+  std::vector<uint8_t> rom_;
+  int frequency_;
+  unsigned int seed_;
+  std::vector<QuirkResult> results_;
+  // Display digest of every frame, per combination
+  std::vector<std::vector<uint64_t>> frames_;
+  std::optional<unsigned int> recommended_;
+  bool ambiguous_ = false;
+
+  /**
+   * Runs one combination, storing its result and frames.
+   * @param quirks
+   * @param cycles
+   */
+  void run_combination(unsigned int quirks, unsigned long cycles);
+
+  /**
+   * @param frame
+   * @returns The keys held during a frame.
+   */
+  uint16_t get_keys(unsigned long frame) const;
+
+  /**
+   * Finds the expected combination and the ones that diverge from it.
+   */
+  void compare();
+};
+
+
+#endif//CHIP8_QUIRKSWEEP_H
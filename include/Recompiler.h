@@ -0,0 +1,91 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_RECOMPILER_H
+#define CHIP8_RECOMPILER_H
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Aot.h"
+#include "Memory.h"
+#include "Opcodes.h"
+
+/**
+ * Static recompiler: translates a ROM to C++ implementing chip8_aot_run().
+ * The instructions reachable from 0x200 are found by following the control flow graph. Indirect
+ * Bnnn jumps and returns are left to the interpreter, as are the instructions that touch the
+ * memory, the display, the keypad, the stack, the sound or the quirks: they are run through
+ * chip8_aot_state::exec.
+ */
+class Recompiler {
+public:
+  /**
+   * Disassembles the ROM and builds its control flow graph.
+   * @param rom ROM contents, loaded at 0x200.
+   */
+  explicit Recompiler(const std::vector<uint8_t> & rom);
+
+  /**
+   * @returns Opcode of every reachable instruction, by address.
+   */
+  const std::map<mem::address_t, op::opcode_t> & get_instructions() const;
+
+  /**
+   * @param address
+   * @param opcode
+   * @returns Addresses execution can continue at after the instruction, when they are known
+   * statically.
+   */
+  std::vector<mem::address_t> get_successors(mem::address_t address, op::opcode_t opcode) const;
+
+  /**
+   * Writes the C++ translation of the ROM.
+   * @param out
+   * @param name ROM name, for the header comment.
+   */
+  void emit(std::ostream & out, const std::string & name) const;
+
+private:
+  std::vector<uint8_t> rom_;
+  std::map<mem::address_t, op::opcode_t> instructions_;
+
+  /**
+   * @param address
+   * @returns A whole opcode is stored at address in the ROM.
+   */
+  bool is_in_rom(mem::address_t address) const;
+
+  /**
+   * @param address
+   * @returns The opcode at address in the ROM.
+   */
+  op::opcode_t opcode_at(mem::address_t address) const;
+
+  /**
+   * @param address
+   * @returns Size of the instruction at address, 4 bytes for F000 NNNN.
+   */
+  uint8_t instruction_size(mem::address_t address) const;
+
+  /**
+   * @param address
+   * @param opcode
+   * @param next Address of the next instruction.
+   * @returns C++ statements implementing the instruction, or an empty string if the interpreter
+   * runs it.
+   */
+  std::string translate(mem::address_t address, op::opcode_t opcode, mem::address_t next) const;
+
+  /**
+   * @param target
+   * @returns C++ statement continuing the execution at target.
+   */
+  std::string jump(mem::address_t target) const;
+};
+
+
+#endif//CHIP8_RECOMPILER_H
@@ -5,39 +5,110 @@
 #define CHIP8_ROMPARSER_H
 
 #include "Configuration.h"
+#include "Fault.h"
 #include "Instructions.h"
 #include "Memory.h"
+#include "NativeCode.h"
+#include "Opcodes.h"
 #include "register/RegisterManager.h"
 
 #include "iostream"
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
 #include <exception>
 #include <fstream>
 #include <memory>
 #include <sstream>
 #include <vector>
 
+/**
+ * Superinstruction counters.
+ */
+struct FusionStats {
+  // Handler calls, a superinstruction counting as one
+  unsigned long dispatches;
+  unsigned long instructions;
+  std::array<unsigned long, static_cast<size_t>(op::Fusion::count)> fused;
+};
+
 class RomParser {
 public:
+  /**
+   * @param configuration
+   * @param memory
+   * @param registerManager
+   * @param instructions
+   * @param load_rom Loads the configured ROM, otherwise the memory is left empty for load().
+   * @throws std::runtime_error if the ROM cannot be opened
+   */
   explicit RomParser(const std::shared_ptr<Configuration> configuration,
                      const std::shared_ptr<mem::Memory> memory,
                      const std::shared_ptr<reg::RegisterManager> registerManager,
-                     const std::shared_ptr<Instructions> instructions);
+                     const std::shared_ptr<Instructions> instructions, bool load_rom = true);
   std::shared_ptr<Configuration> configuration_;
   std::shared_ptr<mem::Memory> memory_;
   std::shared_ptr<reg::RegisterManager> registers_;
   std::shared_ptr<Instructions> instructions_;
 
+  /**
+   * Copies a ROM to 0x200.
+   * @param rom
+   * @throws std::runtime_error if the ROM does not fit in the memory
+   */
+  void load(const std::vector<uint8_t> & rom);
+
+  /**
+   * Loads the ROM another parser loaded, sharing its memory pages until either writes them.
+   * @param loaded
+   */
+  void share(const RomParser & loaded);
+
   /**
    * Goes one step forward in the program execution.
    * Loads OPCODE and increments PC.
+   * @returns Fault::address_out_of_range, also raised in the fault register with PC as its
+   * address, if PC is past the end of the memory, Fault::none otherwise.
    */
-  void step();
+  Fault step();
 
   /**
-   * Decodes the OPCODE and calls the corresponding instruction.
-   * @throws std::runtime_error if OPCODE is unknown
+   * Decodes the OPCODE with a single op::TABLE lookup and calls the corresponding instruction.
+   * A fault it raises is recorded with the address of the instruction.
+   * @returns The fault the instruction raised, Fault::unknown_opcode if OPCODE is unknown,
+   * Fault::none if it ran normally, even if an earlier fault was not cleared.
    */
-  void decode();
+  Fault decode();
+
+  /**
+   * Recognises a superinstruction starting with the fetched OPCODE and executes it in place of
+   * decode(). Only sequences that do not write memory are fused, and only when no timer tick falls
+   * between their instructions, so the result is exactly the one of decoding them in turn.
+   * A jump into the middle of a sequence fetches from there and is decoded normally.
+   * Must be called right after step().
+   * @param max Maximum number of extra cycles the superinstruction may use.
+   * @returns The number of extra cycles used, 0 if nothing was fused.
+   */
+  unsigned short int fuse(unsigned short int max);
+
+  /**
+   * Runs the ROM from native code compiled by CHIP8_AOT whenever possible, the interpreter
+   * running the rest.
+   * @param path Shared object compiled from the ROM.
+   * @throws std::runtime_error if the native code cannot be loaded for this ROM
+   */
+  void load_native(const std::string & path);
+
+  /**
+   * @returns Native code is loaded, and the program did not overwrite the code it was compiled
+   * from.
+   */
+  bool is_native() const;
+
+  /**
+   * @returns Dispatch and superinstruction counters of run().
+   */
+  const FusionStats & get_fusion_stats() const;
 
   /**
    * Extracts the values from the OPCODE.
@@ -48,7 +119,36 @@ public:
   uint16_t get_from_opcode(const uint16_t & opcode, const uint16_t mask);
 
   /**
-   * For testing/debugging
+   * Detects if the decoded OPCODE closes a loop that only a timer tick can exit: a jump to itself,
+   * or a Fx07 / 3xkk / 1nnn delay timer poll. In that case the loop iterations left before the
+   * next tick are fast-forwarded, leaving the machine in the exact state they would have produced.
+   * Must be called right after decode().
+   * @param max Maximum number of cycles to skip.
+   * @returns The number of cycles skipped.
+   */
+  unsigned short int skip_idle(unsigned short int max = 0xFFFF);
+
+  /**
+   * Runs the machine without a display loop, for a budget of cycles, from the native code when it
+   * is loaded.
+   * If the CPU halts on Fx0A, the timers run through the rest of the budget at once and control
+   * is returned to the caller, which can check registers_->halted_ and press a key.
+   * Returns early as well when the program exits with 00FD, or faults and the fault policy stops
+   * the CPU: nothing runs until registers_->faulted_ is cleared.
+   * @param cycles
+   * @returns The number of cycles during which the CPU was running.
+   */
+  unsigned int run(unsigned int cycles);
+
+  /**
+   * Runs frames that are thrown away, see Machine::run_ahead(): a fault stops the CPU without the
+   * trap policy raising SIGTRAP, and ST writes do not request a beep.
+   * @param speculative
+   */
+  void set_speculative(bool speculative);
+
+  /**
+   * For testing/debugging, the opcode being fetched from the address before PC.
    * @param opcode
    */
   void set_opcode(uint16_t opcode);
@@ -58,7 +158,57 @@ private:
   std::vector<uint8_t> contents_;
   std::vector<uint8_t> opcode_encoded_{0x0, 0x0};
   uint16_t opcode_;
-  std::stringstream ss;
+  mem::address_t opcode_address_ = 0x0;
+  FusionStats fusion_stats_{};
+  uint64_t rom_hash_ = 0;
+  std::shared_ptr<NativeCode> native_;
+  bool native_enabled_ = false;
+  bool speculative_ = false;
+  chip8_aot_state native_state_{};
+
+  /**
+   * Applies the fault policy to the fault the last instruction raised.
+   * @returns The CPU stops.
+   */
+  bool stops_on_fault();
+
+  /**
+   * Records the address of the current instruction as the fault address, if it raised a fault.
+   * @param faults Fault count before the instruction ran.
+   * @returns A fault was raised since.
+   */
+  bool record_faults(unsigned long faults);
+
+  /**
+   * Runs the native code from PC.
+   * @param max
+   * @returns The number of instructions executed, 0 if PC is not compiled.
+   */
+  unsigned int run_native(unsigned int max);
+
+  /**
+   * Copies the registers to the native code state.
+   */
+  void store_native_state();
+
+  /**
+   * Copies the native code state to the registers.
+   */
+  void load_native_state();
+
+  /**
+   * Callback of the native code running an instruction through decode().
+   * @param state
+   * @param opcode
+   * @returns The native code must return.
+   */
+  static int exec_native(chip8_aot_state * state, uint16_t opcode);
+
+  /**
+   * @param address
+   * @returns The opcode stored at address, 0x0000 past the end of the memory.
+   */
+  uint16_t peek_opcode(mem::address_t address);
 };
 
 
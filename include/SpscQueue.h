@@ -0,0 +1,57 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_SPSCQUEUE_H
+#define CHIP8_SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Lock-free bounded queue between exactly one producer thread and one consumer thread.
+ * The producer only writes head_ and the consumer only writes tail_, each one on its own cache
+ * line, so neither side ever waits for the other.
+ * @tparam T Copied in and out of the queue.
+ * @tparam N Capacity, a power of 2.
+ */
+template<typename T, size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "The capacity must be a power of 2");
+
+public:
+  /**
+   * Producer side.
+   * @param item
+   * @returns The item was queued, false if the queue is full.
+   */
+  bool push(const T & item) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == N) { return false; }
+    items_[head % N] = item;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Consumer side.
+   * @param item Receives the oldest item.
+   * @returns An item was dequeued, false if the queue is empty.
+   */
+  bool pop(T & item) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (head_.load(std::memory_order_acquire) == tail) { return false; }
+    item = items_[tail % N];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::array<T, N> items_{};
+  // Counts of pushed and popped items, only wrapped when indexing items_
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+
+#endif//CHIP8_SPSCQUEUE_H
@@ -0,0 +1,122 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_VIDEOWRITER_H
+#define CHIP8_VIDEOWRITER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "Display.h"
+#include "SpscQueue.h"
+
+/**
+ * Video output counters.
+ */
+struct VideoStats {
+  unsigned long written;
+  // Frames pushed while the queue was full, or after the output failed
+  unsigned long dropped;
+};
+
+/**
+ * Writes the frames to a file, a FIFO or the standard output as a Y4M stream, for an encoder such
+ * as ffmpeg to read. Frames are 8-bit grayscale at the high resolution, 128x64, low resolution
+ * pixels being doubled, at one frame per timer period. A background thread writes them from a
+ * bounded queue: when the reader is slower, push() drops frames instead of waiting for it.
+ * Pipes and FIFOs are written without blocking, so finish() does not wait for a stalled reader.
+ */
+class VideoWriter {
+public:
+  static constexpr unsigned short int WIDTH = Display::MAX_SIZE_X;
+  static constexpr unsigned short int HEIGHT = Display::MAX_SIZE_Y;
+  // Timer frequency
+  static constexpr unsigned int FRAME_RATE = 60;
+
+  using frame_t = std::array<uint8_t, WIDTH * HEIGHT>;
+
+  /**
+   * Opens the output and starts the writer thread. Opening a FIFO waits for its reader.
+   * @param path Output file, - for the standard output.
+   * @throws std::runtime_error if the output cannot be opened
+   */
+  explicit VideoWriter(const std::string & path);
+
+  /**
+   * Finishes the video.
+   */
+  ~VideoWriter();
+
+  VideoWriter(const VideoWriter &) = delete;
+  VideoWriter & operator=(const VideoWriter &) = delete;
+
+  /**
+   * Queues a frame. Never waits for the writer thread.
+   * @param display
+   * @returns The frame was queued, false if it was dropped.
+   */
+  bool push(const Display & display);
+
+  /**
+   * Writes the frames still queued, then stops the writer thread and closes the output. Later
+   * frames are dropped. A pipe reader that does not take a frame within FINISH_TIMEOUT is given
+   * up on: the frame being written is cut short and the frames left are dropped.
+   */
+  void finish();
+
+  /**
+   * @returns The counters, the frames written being counted once fully written.
+   */
+  VideoStats get_stats() const;
+
+  /**
+   * @param color Palette index.
+   * @returns The luma of a palette color, BT.601.
+   */
+  static uint8_t get_gray(uint8_t color);
+
+  // Longest wait for a pipe reader once finishing
+  static constexpr std::chrono::milliseconds FINISH_TIMEOUT{250};
+
+private:
+  // About 1/4 s of frames at 60 Hz
+  static constexpr size_t QUEUE_SIZE = 16;
+
+  int output_;
+  // File status flags of the output before it was made non-blocking, -1 if it was not
+  int blocking_flags_ = -1;
+  // Set by finish() before stop_
+  std::chrono::steady_clock::time_point stop_deadline_;
+  SpscQueue<frame_t, QUEUE_SIZE> frames_;
+  std::thread writer_;
+  std::atomic<bool> stop_{false};
+  // A write failed, the reader closed the output, or the video was finished
+  std::atomic<bool> failed_{false};
+  std::atomic<unsigned long> written_{0};
+  std::atomic<unsigned long> dropped_{0};
+
+  // Last frame converted, only used by the pushing thread
+  frame_t frame_{};
+  uint64_t display_hash_ = 0;
+  bool frame_valid_ = false;
+
+  /**
+   * Writer thread: writes the queued frames until stopped and the queue is empty.
+   */
+  void write_frames();
+
+  /**
+   * Writes a whole buffer, waiting for a non-blocking output to accept it.
+   * @param data
+   * @param size
+   * @returns The buffer was written, false if the output failed or finish() timed out.
+   */
+  bool write_all(const char * data, size_t size);
+};
+
+
+#endif//CHIP8_VIDEOWRITER_H
@@ -0,0 +1,189 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#ifndef CHIP8_CHIP8_H
+#define CHIP8_CHIP8_H
+
+/*
+ * C interface of libchip8, to embed headless machines in other programs. It does not depend on
+ * SDL, and each machine is independent: different machines may run on different threads.
+ * Functions taking a machine must not be called concurrently for the same machine.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Incremented when a function below changes or is removed
+#define CHIP8_API_VERSION 1
+
+// Frame buffer geometry, see chip8_get_plane()
+#define CHIP8_ROWS 64
+#define CHIP8_ROW_BYTES 16
+
+// Frequencies chip8_create() accepts, the timers ticking every frequency / 60 instructions
+#define CHIP8_MIN_FREQUENCY 60
+#define CHIP8_MAX_FREQUENCY 65535
+
+// Quirks, combined in the quirks argument of chip8_create()
+#define CHIP8_QUIRK_SHIFT_SETS_VY 0x1
+#define CHIP8_QUIRK_JUMP_USES_VX 0x2
+#define CHIP8_QUIRK_LOAD_STORE_INCREMENTS_I 0x4
+#define CHIP8_QUIRK_LOGIC_RESETS_VF 0x8
+
+// Values of chip8_get_status()
+#define CHIP8_RUNNING 0
+// Waiting for a key on Fx0A
+#define CHIP8_HALTED 1
+// The program exited with 00FD
+#define CHIP8_EXITED 2
+// The program faulted, see chip8_get_fault()
+#define CHIP8_FAULTED 3
+
+#if defined(_WIN32)
+#define CHIP8_API __declspec(dllexport)
+#else
+#define CHIP8_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct chip8 chip8;
+
+/**
+ * @returns CHIP8_API_VERSION of the library, to check it against the header.
+ */
+CHIP8_API unsigned int chip8_get_api_version(void);
+
+/**
+ * Creates a machine with an empty memory.
+ * @param frequency Instructions per second, CHIP8_MIN_FREQUENCY to CHIP8_MAX_FREQUENCY.
+ * @param quirks CHIP8_QUIRK_ flags.
+ * @param seed Seed of the random numbers, 0 for a random one.
+ * @returns The machine, NULL on failure or if frequency is out of range.
+ */
+CHIP8_API chip8 * chip8_create(unsigned int frequency, unsigned int quirks, unsigned int seed);
+
+CHIP8_API void chip8_destroy(chip8 * machine);
+
+/**
+ * Resets the machine to its initial state and copies a ROM to 0x200.
+ * @returns 0, -1 if the ROM does not fit in the memory.
+ */
+CHIP8_API int chip8_load_rom(chip8 * machine, const uint8_t * rom, size_t size);
+
+/**
+ * Runs the CPU for a number of cycles, the timers ticking at 60 Hz of emulated time.
+ * @returns The number of cycles during which the CPU was running, lower when it halted, exited
+ * or faulted.
+ */
+CHIP8_API unsigned int chip8_run_cycles(chip8 * machine, unsigned int cycles);
+
+/**
+ * Runs the CPU up to the next timer tick, a 60th of a second of emulated time.
+ * @returns As chip8_run_cycles().
+ */
+CHIP8_API unsigned int chip8_run_frame(chip8 * machine);
+
+/**
+ * @param keys Keys held down, bit n for key n.
+ */
+CHIP8_API void chip8_set_keys(chip8 * machine, uint16_t keys);
+
+/**
+ * @returns One of CHIP8_RUNNING, CHIP8_HALTED, CHIP8_EXITED, CHIP8_FAULTED.
+ */
+CHIP8_API int chip8_get_status(const chip8 * machine);
+
+/**
+ * @returns Name of the last fault, NULL if the program never faulted.
+ */
+CHIP8_API const char * chip8_get_fault(const chip8 * machine);
+
+/**
+ * @returns Non-zero while the sound timer is running.
+ */
+CHIP8_API int chip8_is_buzzing(const chip8 * machine);
+
+/**
+ * @returns Width and height in pixels of the current resolution, 64x32 or 128x64.
+ */
+CHIP8_API unsigned int chip8_get_width(const chip8 * machine);
+CHIP8_API unsigned int chip8_get_height(const chip8 * machine);
+
+/**
+ * @returns Number of bitplanes of the frame buffer, 1, or up to 4 in the XO-CHIP build.
+ */
+CHIP8_API unsigned int chip8_get_planes(const chip8 * machine);
+
+/**
+ * Frame buffer of a plane, updated in place as the machine runs: CHIP8_ROWS rows of
+ * CHIP8_ROW_BYTES bytes, each row holding a native-endian 128-bit integer whose bit 127 - x is
+ * pixel x. Only the top left chip8_get_width() x chip8_get_height() pixels are displayed.
+ * @returns The frame buffer, valid until the machine is destroyed. NULL for a missing plane.
+ */
+CHIP8_API const uint8_t * chip8_get_plane(const chip8 * machine, unsigned int plane);
+
+/**
+ * Fingerprint of the memory, the registers, the frame buffer and the keys, kept up to date as the
+ * machine runs, so it costs the same whatever the memory size. Equal states have equal
+ * fingerprints, and different states almost never do. The random number generator is left out.
+ */
+CHIP8_API uint64_t chip8_get_state_hash(const chip8 * machine);
+
+/*
+ * Batches of instances of the same ROM stepping together, one frame per step, on a pool of
+ * threads. The inputs and outputs of all the instances are each in one buffer.
+ */
+
+typedef struct chip8_batch chip8_batch;
+
+/**
+ * @param size Number of instances.
+ * @param threads Threads stepping the instances, the calling thread included.
+ * @param frequency As chip8_create().
+ * @param quirks As chip8_create().
+ * @param seed As chip8_create(), instance n using seed + n if it is not 0.
+ * @returns The batch, NULL on failure.
+ */
+CHIP8_API chip8_batch * chip8_batch_create(size_t size, unsigned int threads,
+                                           unsigned int frequency, unsigned int quirks,
+                                           unsigned int seed, const uint8_t * rom,
+                                           size_t rom_size);
+
+CHIP8_API void chip8_batch_destroy(chip8_batch * batch);
+
+/**
+ * Runs every instance up to its next timer tick.
+ * @param actions Keys held down by each instance, bit n for key n.
+ */
+CHIP8_API void chip8_batch_step(chip8_batch * batch, const uint16_t * actions);
+
+/**
+ * Brings an instance back to its state after the ROM was loaded.
+ */
+CHIP8_API void chip8_batch_reset(chip8_batch * batch, size_t index);
+
+/**
+ * @returns The frame buffers after the last step, valid until the batch is destroyed: for each
+ * instance, chip8_get_planes() planes laid out as chip8_get_plane() describes.
+ */
+CHIP8_API const uint8_t * chip8_batch_get_observations(const chip8_batch * batch);
+
+/**
+ * @returns The status of each instance after the last step, as chip8_get_status().
+ */
+CHIP8_API const uint8_t * chip8_batch_get_status(const chip8_batch * batch);
+
+/**
+ * @returns The state fingerprint of each instance after the last step, as
+ * chip8_get_state_hash().
+ */
+CHIP8_API const uint64_t * chip8_batch_get_hashes(const chip8_batch * batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CHIP8_CHIP8_H
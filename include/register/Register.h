@@ -13,7 +13,7 @@ class Register {
 public:
   Register();
   void poke(T value);
-  T peek();
+  T peek() const;
   void increment(short int number = 1);
   void decrement(short int number = 1);
 
@@ -30,7 +30,7 @@ void Register<T>::poke(T value) {
   value_ = value;
 }
 template<class T>
-T Register<T>::peek() {
+T Register<T>::peek() const {
   return value_;
 }
 
@@ -4,6 +4,7 @@
 #ifndef CHIP8_REGISTERMANAGER_H
 #define CHIP8_REGISTERMANAGER_H
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
@@ -11,6 +12,7 @@
 #include <stdexcept>
 #include <vector>
 
+#include "Fault.h"
 #include "register/Register.h"
 
 namespace reg {
@@ -38,11 +40,75 @@ namespace reg {
     // 16x 16-bit stack
     std::stack<uint16_t> stack_;
 
+    // Subroutine nesting levels, as on the HP48
+    static constexpr unsigned short int STACK_SIZE = 16;
+
+    // The CPU is halted by Fx0A until a key is pressed
+    bool halted_ = false;
+
+    // Register receiving the key that resumes the CPU
+    regnb_t key_register_ = 0x0;
+
+    // 00FD exits the interpreter
+    bool exited_ = false;
+
+    // Fault register: last fault and address of the instruction that raised it
+    Fault fault_ = Fault::none;
+    uint16_t fault_address_ = 0x0;
+    unsigned long faults_ = 0;
+
+    // A fault stopped the CPU, until the owner clears it
+    bool faulted_ = false;
+
+    // SUPER-CHIP RPL user flags, saved and restored by Fx75 and Fx85
+    std::array<uint8_t, 0x10> rpl_{};
+
+    // XO-CHIP 1-bit audio samples loaded by F002, played while ST is non-zero
+    std::array<uint8_t, 0x10> audio_pattern_{};
+
+    // The buzzer plays audio_pattern_ instead of the default tone once F002 was executed
+    bool audio_pattern_loaded_ = false;
+
+    // XO-CHIP playback rate of audio_pattern_, 4000 * 2 ^ ((pitch - 64) / 48) bits per second
+    uint8_t pitch_ = 64;
+
+    /**
+     * Records a fault of the current instruction and stops the CPU. The fault policy decides
+     * whether it resumes.
+     * @param fault
+     */
+    void raise(Fault fault);
+
     /**
      * Decrements the timers at a fixed 60Hz frequency.
      */
     void trigger_timers();
 
+    /**
+     * @returns The number of calls to trigger_timers() until the timers are next decremented,
+     * including the call that decrements them. Returns 0 if the timers never tick.
+     */
+    unsigned short int cycles_to_next_tick() const;
+
+    /**
+     * Accounts for cycles that were skipped without calling trigger_timers().
+     * Must be lower than cycles_to_next_tick() so no tick is missed.
+     * @param cycles
+     */
+    void skip_cycles(unsigned short int cycles);
+
+    /**
+     * Runs the timers for a number of cycles at once, as many calls to trigger_timers() would.
+     * @param cycles
+     */
+    void elapse(unsigned int cycles);
+
+    /**
+     * @returns Fingerprint of every register and flag, the timer phase included, computed from
+     * their few bytes. The fault count is left out.
+     */
+    uint64_t get_hash() const;
+
   private:
     unsigned short int counter_ = 0;
     unsigned short int decrement_interval_;
@@ -0,0 +1,177 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Batch.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+  const mem::address_t ROM_START = 0x200;
+}// namespace
+
+Batch::Batch(const std::shared_ptr<Configuration> & configuration,
+             const std::vector<uint8_t> & rom, size_t size, unsigned int threads, bool lanes) {
+  if (size == 0 || threads == 0) {
+    throw std::runtime_error("A batch needs at least one instance and one thread.");
+  }
+  if (rom.size() > mem::MEMORY_SIZE - ROM_START) {
+    throw std::runtime_error("The ROM does not fit in the memory.");
+  }
+
+  machines_.reserve(size);
+  initial_.reserve(size);
+  for (size_t index = 0; index < size; index++) {
+    std::shared_ptr<Configuration> instance = configuration;
+    if (configuration->getSeed() != 0) {
+      instance = std::make_shared<Configuration>(*configuration);
+      instance->setSeed(configuration->getSeed() + index);
+    }
+    machines_.emplace_back(instance, false);
+    if (index == 0) {
+      machines_.back().romParser_->load(rom);
+    } else {
+      machines_.back().romParser_->share(*machines_[0].romParser_);
+    }
+    initial_.push_back(machines_.back().save());
+  }
+
+  for (size_t first = 0; lanes && first < size; first += LaneGroup::LANES) {
+    std::vector<Machine *> group;
+    for (size_t index = first; index < std::min<size_t>(first + LaneGroup::LANES, size); index++) {
+      group.push_back(&machines_[index]);
+    }
+    groups_.emplace_back(group);
+  }
+
+  observations_.resize(size * OBSERVATION_ROWS);
+  status_.resize(size);
+  hashes_.resize(size);
+  for (size_t index = 0; index < size; index++) { observe(index); }
+
+  threads = std::min<size_t>(threads, lanes ? groups_.size() : size);
+  for (unsigned int slice = 1; slice < threads; slice++) {
+    workers_.emplace_back(&Batch::work, this, slice);
+  }
+}
+
+Batch::~Batch() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  started_.notify_all();
+  for (std::thread & worker : workers_) { worker.join(); }
+}
+
+void Batch::step(const uint16_t * actions) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    actions_ = actions;
+    running_ = workers_.size();
+    generation_++;
+  }
+  started_.notify_all();
+
+  step_slice(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  finished_.wait(lock, [this] { return running_ == 0; });
+}
+
+void Batch::reset(size_t index) {
+  machines_[index].restore(initial_[index]);
+  observe(index);
+}
+
+size_t Batch::size() const {
+  return machines_.size();
+}
+
+const Display::row_t * Batch::get_observations() const {
+  return observations_.data();
+}
+
+const Status * Batch::get_status() const {
+  return status_.data();
+}
+
+const uint64_t * Batch::get_hashes() const {
+  return hashes_.data();
+}
+
+Machine & Batch::get_machine(size_t index) {
+  return machines_[index];
+}
+
+LaneStats Batch::get_lane_stats() const {
+  LaneStats total{};
+  for (const LaneGroup & group : groups_) {
+    total.vector += group.get_stats().vector;
+    total.lanes += group.get_stats().lanes;
+    total.scalar += group.get_stats().scalar;
+  }
+  return total;
+}
+
+void Batch::work(unsigned int slice) {
+  unsigned long generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      started_.wait(lock, [&] { return stopping_ || generation_ != generation; });
+      if (stopping_) { return; }
+      generation = generation_;
+    }
+
+    step_slice(slice);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--running_ == 0) { finished_.notify_one(); }
+  }
+}
+
+void Batch::step_slice(unsigned int slice) {
+  size_t slices = workers_.size() + 1;
+
+  if (!groups_.empty()) {
+    size_t begin = groups_.size() * slice / slices;
+    size_t end = groups_.size() * (slice + 1) / slices;
+    size_t first = begin * LaneGroup::LANES;
+    size_t last = std::min<size_t>(end * LaneGroup::LANES, machines_.size());
+
+    for (size_t index = first; index < last; index++) {
+      machines_[index].interface_->keypad_->set_mask(actions_[index]);
+    }
+    for (size_t group = begin; group < end; group++) { groups_[group].run_frame(); }
+    for (size_t index = first; index < last; index++) { observe(index); }
+    return;
+  }
+
+  size_t begin = machines_.size() * slice / slices;
+  size_t end = machines_.size() * (slice + 1) / slices;
+  for (size_t index = begin; index < end; index++) {
+    Machine & machine = machines_[index];
+    machine.interface_->keypad_->set_mask(actions_[index]);
+    machine.romParser_->run(
+            std::max<unsigned short int>(machine.registers_->cycles_to_next_tick(), 1));
+    observe(index);
+  }
+}
+
+void Batch::observe(size_t index) {
+  const Machine & machine = machines_[index];
+  const Display & display = *machine.interface_->display_;
+  Display::row_t * observation = &observations_[index * OBSERVATION_ROWS];
+  for (uint8_t plane = 0; plane < Display::PLANES; plane++) {
+    std::copy_n(display.get_plane(plane), Display::MAX_SIZE_Y,
+                observation + plane * Display::MAX_SIZE_Y);
+  }
+
+  const reg::RegisterManager & registers = *machine.registers_;
+  status_[index] = registers.faulted_  ? Status::faulted
+                   : registers.exited_ ? Status::exited
+                   : registers.halted_ ? Status::halted
+                                       : Status::running;
+  hashes_[index] = machine.get_hash();
+}
@@ -33,4 +33,100 @@ bool Configuration::isCFx55Fx65IncrementsI() const {
 
 bool Configuration::isC8Xy18Xy28Xy3ResetVf() const {
   return c_8xy1_8xy2_8xy3_reset_vf_;
-}
\ No newline at end of file
+}
+
+const std::string & Configuration::getKeymap() const {
+  return keymap_;
+}
+
+void Configuration::setKeymap(const std::string & keymap) {
+  keymap_ = keymap;
+}
+
+int Configuration::getAudioSampleRate() const {
+  return audio_sample_rate_;
+}
+
+void Configuration::setAudioSampleRate(int sampleRate) {
+  audio_sample_rate_ = sampleRate;
+}
+
+int Configuration::getAudioBufferSamples() const {
+  return audio_buffer_samples_;
+}
+
+void Configuration::setAudioBufferSamples(int bufferSamples) {
+  audio_buffer_samples_ = bufferSamples;
+}
+
+bool Configuration::isFusion() const {
+  return fusion_;
+}
+
+void Configuration::setFusion(bool fusion) {
+  fusion_ = fusion;
+}
+
+const std::string & Configuration::getNativePath() const {
+  return native_path_;
+}
+
+void Configuration::setNativePath(const std::string & nativePath) {
+  native_path_ = nativePath;
+}
+
+bool Configuration::isIdleSkip() const {
+  return idle_skip_;
+}
+
+void Configuration::setIdleSkip(bool idleSkip) {
+  idle_skip_ = idleSkip;
+}
+
+unsigned int Configuration::getSeed() const {
+  return seed_;
+}
+
+void Configuration::setSeed(unsigned int seed) {
+  seed_ = seed;
+}
+
+FaultPolicy Configuration::getFaultPolicy() const {
+  return fault_policy_;
+}
+
+void Configuration::setFaultPolicy(FaultPolicy faultPolicy) {
+  fault_policy_ = faultPolicy;
+}
+
+unsigned int Configuration::getMaxFrameskip() const {
+  return max_frameskip_;
+}
+
+void Configuration::setMaxFrameskip(unsigned int maxFrameskip) {
+  max_frameskip_ = maxFrameskip;
+}
+
+unsigned int Configuration::getRunAhead() const {
+  return run_ahead_;
+}
+
+void Configuration::setRunAhead(unsigned int runAhead) {
+  run_ahead_ = runAhead;
+}
+
+const std::string & Configuration::getExportName() const {
+  return export_name_;
+}
+
+void Configuration::setExportName(const std::string & exportName) {
+  export_name_ = exportName;
+}
+
+const std::string & Configuration::getVideoPath() const {
+  return video_path_;
+}
+
+void Configuration::setVideoPath(const std::string & videoPath) {
+  video_path_ = videoPath;
+}
@@ -0,0 +1,178 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Display.h"
+
+#include "Fingerprint.h"
+
+Display::Display() {
+  set_hires(false);
+}
+
+unsigned short int Display::size_x() const {
+  return hires_ ? MAX_SIZE_X : MAX_SIZE_X / 2;
+}
+
+unsigned short int Display::size_y() const {
+  return hires_ ? MAX_SIZE_Y : MAX_SIZE_Y / 2;
+}
+
+bool Display::is_hires() const {
+  return hires_;
+}
+
+void Display::set_hires(bool hires) {
+  hires_ = hires;
+  for (plane_t & plane : planes_) { plane.fill(0); }
+  rehash();
+}
+
+void Display::select_planes(uint8_t mask) {
+  plane_mask_ = mask & ((1 << PLANES) - 1);
+}
+
+uint8_t Display::get_planes() const {
+  return plane_mask_;
+}
+
+void Display::clear() {
+  for (uint8_t p = 0; p < PLANES; p++) {
+    if (is_selected(p)) { planes_[p].fill(0); }
+  }
+  rehash();
+}
+
+bool Display::is_pixel_on(int x, int y) const {
+  return get_color(x, y) != 0;
+}
+
+uint8_t Display::get_color(int x, int y) const {
+  if (x < 0 || y < 0 || x >= size_x() || y >= size_y()) {
+    throw std::runtime_error("Tried to get the value of an out of bound pixel.");
+  }
+
+  uint8_t color = 0;
+  for (uint8_t p = 0; p < PLANES; p++) {
+    color |= ((planes_[p][y] >> (MAX_SIZE_X - 1 - x)) & 0x1) << p;
+  }
+  return color;
+}
+
+void Display::set_pixel_state(unsigned short int x, unsigned short int y, bool on) {
+  row_t pixel = (row_t) 0x1 << (MAX_SIZE_X - 1 - x);
+  for (uint8_t p = 0; p < PLANES; p++) {
+    if (is_selected(p)) { set_row(p, y, on ? planes_[p][y] | pixel : planes_[p][y] & ~pixel); }
+  }
+}
+
+bool Display::draw_sprite(uint8_t x, uint8_t y, const uint16_t * rows, uint8_t height,
+                          uint8_t width) {
+  x %= size_x();
+  y %= size_y();
+  bool collision = false;
+
+  for (uint8_t p = 0; p < PLANES; p++) {
+    if (!is_selected(p)) { continue; }
+
+    for (uint8_t row = 0; row < height; row++) {
+      // Align the sprite on the left edge, then move it to x.
+      row_t sprite = (row_t) rows[row] << (MAX_SIZE_X - width);
+      row_t line = sprite >> x;
+
+      // Pixels past the right edge wrap around to the left edge.
+      if (!hires_) {
+        line |= line << (MAX_SIZE_X / 2);
+      } else if (x > 0) {
+        line |= sprite << (MAX_SIZE_X - x);
+      }
+      line &= row_mask();
+
+      unsigned short int target = (y + row) % size_y();
+      collision |= (planes_[p][target] & line) != 0;
+      set_row(p, target, planes_[p][target] ^ line);
+    }
+    // The next plane reads the following rows.
+    rows += height;
+  }
+  return collision;
+}
+
+void Display::scroll_down(uint8_t n) {
+  n = std::min<uint8_t>(n, size_y());
+  for (uint8_t p = 0; p < PLANES; p++) {
+    if (!is_selected(p)) { continue; }
+    plane_t & rows = planes_[p];
+    std::copy_backward(rows.begin(), rows.begin() + size_y() - n, rows.begin() + size_y());
+    std::fill(rows.begin(), rows.begin() + n, 0);
+  }
+  rehash();
+}
+
+void Display::scroll_up(uint8_t n) {
+  n = std::min<uint8_t>(n, size_y());
+  for (uint8_t p = 0; p < PLANES; p++) {
+    if (!is_selected(p)) { continue; }
+    plane_t & rows = planes_[p];
+    std::copy(rows.begin() + n, rows.begin() + size_y(), rows.begin());
+    std::fill(rows.begin() + size_y() - n, rows.begin() + size_y(), 0);
+  }
+  rehash();
+}
+
+void Display::scroll_right(uint8_t n) {
+  for (uint8_t p = 0; p < PLANES; p++) {
+    if (!is_selected(p)) { continue; }
+    for (unsigned short int y = 0; y < size_y(); y++) {
+      set_row(p, y, (planes_[p][y] >> n) & row_mask());
+    }
+  }
+}
+
+void Display::scroll_left(uint8_t n) {
+  for (uint8_t p = 0; p < PLANES; p++) {
+    if (!is_selected(p)) { continue; }
+    for (unsigned short int y = 0; y < size_y(); y++) {
+      set_row(p, y, (planes_[p][y] << n) & row_mask());
+    }
+  }
+}
+
+Display::row_t Display::get_row(unsigned short int y, uint8_t plane) const {
+  return planes_[plane][y];
+}
+
+const Display::row_t * Display::get_plane(uint8_t plane) const {
+  return planes_[plane].data();
+}
+
+uint64_t Display::get_hash() const {
+  return fingerprint::of(fingerprint::of(rows_hash_, hires_), plane_mask_);
+}
+
+bool Display::is_selected(uint8_t plane) const {
+  return (plane_mask_ >> plane) & 0x1;
+}
+
+Display::row_t Display::row_mask() const {
+  return hires_ ? ~(row_t) 0 : ~(row_t) 0 << (MAX_SIZE_X / 2);
+}
+
+uint64_t Display::hash_row(uint8_t plane, unsigned short int y, row_t row) {
+  uint64_t key = fingerprint::DISPLAY + (plane << 8) + y;
+  return fingerprint::of(fingerprint::of(key, static_cast<uint64_t>(row)),
+                         static_cast<uint64_t>(row >> 64));
+}
+
+void Display::set_row(uint8_t plane, unsigned short int y, row_t row) {
+  rows_hash_ += hash_row(plane, y, row) - hash_row(plane, y, planes_[plane][y]);
+  planes_[plane][y] = row;
+}
+
+void Display::rehash() {
+  rows_hash_ = 0;
+  for (uint8_t p = 0; p < PLANES; p++) {
+    for (unsigned short int y = 0; y < MAX_SIZE_Y; y++) {
+      rows_hash_ += hash_row(p, y, planes_[p][y]);
+    }
+  }
+}
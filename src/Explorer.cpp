@@ -0,0 +1,207 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Explorer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+  const mem::address_t ROM_START = 0x200;
+}// namespace
+
+Explorer::Explorer(const std::shared_ptr<Configuration> & configuration,
+                   const std::vector<uint8_t> & rom, unsigned int threads, size_t beam_width,
+                   unsigned int frames, const std::vector<uint16_t> & inputs)
+    : configuration_(configuration), threads_(threads), beam_width_(beam_width), frames_(frames),
+      inputs_(inputs.empty() ? get_single_keys() : inputs), coverage_(mem::MEMORY_SIZE) {
+  if (rom.size() > mem::MEMORY_SIZE - ROM_START) {
+    throw std::runtime_error("The ROM does not fit in memory.");
+  }
+  if (!threads || !frames) { throw std::runtime_error("No thread or no frame to explore with."); }
+
+  Machine machine(configuration_, false);
+  machine.romParser_->load(rom);
+  machine.interface_->keypad_->set_mask(0x0);
+  traces_.push_back({0, 0x0});
+  frontier_.push_back({0, machine.get_hash(), machine.save()});
+  visited_.insert(frontier_[0].hash);
+  stats_ = {0, 1, 1, 0, 0.0};
+
+  machines_.reserve(threads_);
+  for (unsigned int thread = 0; thread < threads_; thread++) {
+    machines_.emplace_back(configuration_, false);
+  }
+  for (unsigned int thread = 1; thread < threads_; thread++) {
+    workers_.emplace_back(&Explorer::work, this, thread);
+  }
+}
+
+Explorer::~Explorer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  started_.notify_all();
+  for (std::thread & worker : workers_) { worker.join(); }
+}
+
+bool Explorer::expand() {
+  auto start = std::chrono::steady_clock::now();
+
+  children_.resize(frontier_.size());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    next_ = 0;
+    running_ = workers_.size();
+    generation_++;
+  }
+  started_.notify_all();
+
+  expand_nodes(machines_[0]);
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, [this] { return running_ == 0; });
+  }
+
+  // Merged in the frontier order, so the threads do not change the result
+  std::vector<Node> next_frontier;
+  std::vector<size_t> scores;
+  std::vector<bool> covered = coverage_;
+  for (size_t node = 0; node < frontier_.size(); node++) {
+    bool still = true;
+    for (Child & child : children_[node]) {
+      const reg::RegisterManager & registers = child.snapshot.registers;
+      size_t score = 0;
+      for (mem::address_t pc : child.pcs) {
+        if (!covered[pc]) { score++; }
+        coverage_[pc] = true;
+      }
+      still = still && child.hash == frontier_[node].hash;
+      if (!visited_.insert(child.hash).second) { continue; }
+
+      traces_.push_back({frontier_[node].trace, child.input});
+      if (registers.faulted_) {
+        findings_.push_back({FindingKind::fault, registers.fault_, registers.fault_address_,
+                             get_inputs(traces_.size() - 1)});
+      } else if (registers.exited_) {
+        findings_.push_back({FindingKind::exit, Fault::none, registers.pc_.peek(),
+                             get_inputs(traces_.size() - 1)});
+      } else {
+        next_frontier.push_back({traces_.size() - 1, child.hash, std::move(child.snapshot)});
+        scores.push_back(score);
+      }
+    }
+    // Waiting for a key is not hanging, unless none of the inputs is the awaited one
+    if (still && !children_[node].empty()) {
+      findings_.push_back({FindingKind::hang, Fault::none,
+                           frontier_[node].snapshot.registers.pc_.peek(),
+                           get_inputs(frontier_[node].trace)});
+    }
+  }
+  // The snapshots left are not needed anymore, the next level reuses the outer vector
+  children_.clear();
+
+  if (beam_width_ && next_frontier.size() > beam_width_) {
+    // Most new instructions first, then frontier order
+    std::vector<size_t> order(next_frontier.size());
+    for (size_t i = 0; i < order.size(); i++) { order[i] = i; }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+    order.resize(beam_width_);
+    std::sort(order.begin(), order.end());
+    std::vector<Node> beam;
+    beam.reserve(beam_width_);
+    for (size_t i : order) { beam.push_back(std::move(next_frontier[i])); }
+    next_frontier = std::move(beam);
+  }
+  frontier_ = std::move(next_frontier);
+
+  stats_.depth++;
+  stats_.states = visited_.size();
+  stats_.frontier = frontier_.size();
+  stats_.unique_pcs = std::count(coverage_.begin(), coverage_.end(), true);
+  stats_.seconds +=
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return !frontier_.empty();
+}
+
+const ExplorerStats & Explorer::get_stats() const {
+  return stats_;
+}
+
+const std::vector<Finding> & Explorer::get_findings() const {
+  return findings_;
+}
+
+bool Explorer::is_covered(mem::address_t address) const {
+  return address < coverage_.size() && coverage_[address];
+}
+
+std::vector<uint16_t> Explorer::get_single_keys() {
+  std::vector<uint16_t> inputs = {0x0};
+  for (unsigned int key = 0; key < 0x10; key++) { inputs.push_back(0x1 << key); }
+  return inputs;
+}
+
+void Explorer::work(unsigned int thread) {
+  unsigned long generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      started_.wait(lock, [&] { return stopping_ || generation_ != generation; });
+      if (stopping_) { return; }
+      generation = generation_;
+    }
+
+    expand_nodes(machines_[thread]);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--running_ == 0) { finished_.notify_one(); }
+  }
+}
+
+void Explorer::expand_nodes(Machine & machine) {
+  for (size_t node = next_++; node < frontier_.size(); node = next_++) {
+    children_[node] = expand_node(machine, frontier_[node]);
+  }
+}
+
+std::vector<Explorer::Child> Explorer::expand_node(Machine & machine, const Node & node) const {
+  const reg::RegisterManager & registers = *machine.registers_;
+  std::vector<Child> children;
+  children.reserve(inputs_.size());
+  for (uint16_t input : inputs_) {
+    machine.restore(node.snapshot);
+    machine.interface_->keypad_->set_mask(input);
+
+    // One instruction at a time, to record the address of each
+    std::vector<mem::address_t> pcs;
+    for (unsigned int frame = 0; frame < frames_; frame++) {
+      unsigned int cycles = std::max<unsigned int>(registers.cycles_to_next_tick(), 1);
+      for (unsigned int cycle = 0; cycle < cycles; cycle++) {
+        if (registers.exited_ || registers.faulted_) { break; }
+        if (!registers.halted_ && registers.pc_.peek() < mem::MEMORY_SIZE) {
+          pcs.push_back(registers.pc_.peek());
+        }
+        machine.romParser_->run(1);
+      }
+    }
+    std::sort(pcs.begin(), pcs.end());
+    pcs.erase(std::unique(pcs.begin(), pcs.end()), pcs.end());
+
+    // The keys are set again before each input, states only differing by them are the same
+    machine.interface_->keypad_->set_mask(0x0);
+    children.push_back({input, machine.get_hash(), machine.save(), std::move(pcs)});
+  }
+  return children;
+}
+
+std::vector<uint16_t> Explorer::get_inputs(size_t trace) const {
+  std::vector<uint16_t> inputs;
+  for (; trace; trace = traces_[trace].parent) { inputs.push_back(traces_[trace].input); }
+  std::reverse(inputs.begin(), inputs.end());
+  return inputs;
+}
@@ -0,0 +1,143 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "FrameExport.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  std::runtime_error make_error(const std::string & what, const std::string & name) {
+    return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+  }
+}// namespace
+
+FrameExport::FrameExport(const std::string & name) : name_(name) {
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) { throw make_error("Unable to create the shared memory", name); }
+  if (ftruncate(fd, sizeof(FrameRegion)) != 0) {
+    close(fd);
+    shm_unlink(name.c_str());
+    throw make_error("Unable to size the shared memory", name);
+  }
+  void * address = mmap(nullptr, sizeof(FrameRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw make_error("Unable to map the shared memory", name);
+  }
+
+  // The object is zero filled, which is the initial state of the atomics
+  region_ = static_cast<FrameRegion *>(address);
+  region_->magic = FrameRegion::MAGIC;
+  region_->frame_size = sizeof(ExportedFrame);
+}
+
+FrameExport::~FrameExport() {
+  munmap(region_, sizeof(FrameRegion));
+  // Readers keep their mapping
+  shm_unlink(name_.c_str());
+}
+
+void FrameExport::publish(const Machine & machine, const FrameStats & stats) {
+  const reg::RegisterManager & registers = *machine.registers_;
+  const Display & display = *machine.interface_->display_;
+
+  frame_.frame = stats.frames;
+  frame_.instructions = machine.romParser_->get_fusion_stats().instructions;
+  frame_.faults = registers.faults_;
+  frame_.late = stats.late;
+  frame_.skipped = stats.skipped;
+  frame_.pc = registers.pc_.peek();
+  frame_.keys = machine.interface_->keypad_->get_mask();
+  frame_.width = display.size_x();
+  frame_.height = display.size_y();
+  frame_.dt = registers.dt_.peek();
+  frame_.st = registers.st_.peek();
+  frame_.fault = static_cast<uint8_t>(registers.fault_);
+  frame_.flags = (registers.halted_ ? ExportedFrame::FLAG_HALTED : 0) |
+                 (registers.exited_ ? ExportedFrame::FLAG_EXITED : 0) |
+                 (registers.faulted_ ? ExportedFrame::FLAG_FAULTED : 0) |
+                 (display.is_hires() ? ExportedFrame::FLAG_HIRES : 0);
+
+  if (!pixels_valid_ || display.get_hash() != display_hash_) {
+    std::memset(frame_.pixels, 0, sizeof(frame_.pixels));
+    for (uint8_t plane = 0; plane < Display::PLANES; plane++) {
+      for (unsigned short int y = 0; y < display.size_y(); y++) {
+        Display::row_t row = display.get_row(y, plane);
+        for (unsigned short int x = 0; row && x < display.size_x(); x++) {
+          frame_.pixels[y][x] |= ((row >> (Display::MAX_SIZE_X - 1 - x)) & 0x1) << plane;
+        }
+      }
+    }
+    display_hash_ = display.get_hash();
+    pixels_valid_ = true;
+  }
+
+  uint64_t words[FrameRegion::WORDS];
+  std::memcpy(words, &frame_, sizeof(frame_));
+  uint64_t sequence = region_->sequence.load(std::memory_order_relaxed);
+  region_->sequence.store(sequence + 1, std::memory_order_relaxed);
+  // The odd sequence is visible before any word changes
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < FrameRegion::WORDS; i++) {
+    region_->words[i].store(words[i], std::memory_order_relaxed);
+  }
+  region_->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+uint64_t FrameExport::get_published() const {
+  return region_->sequence.load(std::memory_order_relaxed) / 2;
+}
+
+FrameExportReader::FrameExportReader(const std::string & name) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) { throw make_error("Unable to open the shared memory", name); }
+  struct stat status {};
+  if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(FrameRegion)) {
+    close(fd);
+    throw std::runtime_error("The shared memory " + name + " is not a CHIP8 frame export.");
+  }
+  void * address = mmap(nullptr, sizeof(FrameRegion), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) { throw make_error("Unable to map the shared memory", name); }
+
+  region_ = static_cast<const FrameRegion *>(address);
+  if (region_->magic != FrameRegion::MAGIC || region_->frame_size != sizeof(ExportedFrame)) {
+    munmap(const_cast<FrameRegion *>(region_), sizeof(FrameRegion));
+    throw std::runtime_error("The shared memory " + name + " has another frame layout.");
+  }
+}
+
+FrameExportReader::~FrameExportReader() {
+  munmap(const_cast<FrameRegion *>(region_), sizeof(FrameRegion));
+}
+
+bool FrameExportReader::read(ExportedFrame & frame) const {
+  uint64_t words[FrameRegion::WORDS];
+  for (unsigned int attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+    uint64_t sequence = region_->sequence.load(std::memory_order_acquire);
+    if (sequence == 0) { return false; }
+    if (sequence & 0x1) { continue; }
+    for (size_t i = 0; i < FrameRegion::WORDS; i++) {
+      words[i] = region_->words[i].load(std::memory_order_relaxed);
+    }
+    // The words are read before the sequence is checked again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (region_->sequence.load(std::memory_order_relaxed) == sequence) {
+      std::memcpy(&frame, words, sizeof(frame));
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t FrameExportReader::get_published() const {
+  return region_->sequence.load(std::memory_order_acquire) / 2;
+}
@@ -0,0 +1,46 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "FramePacer.h"
+
+FramePacer::FramePacer(unsigned int max_skip) : max_skip_(max_skip) {}
+
+FramePacer::clock::time_point FramePacer::begin(clock::duration period, clock::time_point now) {
+  if (!started_) {
+    deadline_ = now;
+    started_ = true;
+  } else if (now - deadline_ > MAX_LATENESS) {
+    deadline_ = now;
+    stats_.resyncs++;
+  }
+  deadline_ += period;
+  return deadline_;
+}
+
+void FramePacer::end(clock::time_point now) {
+  stats_.frames++;
+  late_ = now > deadline_;
+  if (!late_) { return; }
+
+  stats_.late++;
+  double lateness = std::chrono::duration<double, std::milli>(now - deadline_).count();
+  if (lateness > stats_.max_lateness) { stats_.max_lateness = lateness; }
+}
+
+bool FramePacer::should_present() {
+  if (late_ && skipped_in_a_row_ < max_skip_) {
+    skipped_in_a_row_++;
+    stats_.skipped++;
+    return false;
+  }
+  skipped_in_a_row_ = 0;
+  return true;
+}
+
+void FramePacer::mark_presented() {
+  stats_.presented++;
+}
+
+const FrameStats & FramePacer::get_stats() const {
+  return stats_;
+}
@@ -0,0 +1,22 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Frontend.h"
+
+void Frontend::render() {
+  render_requested_ = true;
+}
+
+bool Frontend::take_render_request() {
+  bool requested = render_requested_;
+  render_requested_ = false;
+  return requested;
+}
+
+bool Frontend::is_pressed(uint8_t key) const {
+  return keypad_->is_pressed(key);
+}
+
+uint8_t Frontend::get_any_pressed() const {
+  return keypad_->get_any_pressed();
+}
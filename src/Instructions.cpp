@@ -6,42 +6,107 @@
 Instructions::Instructions(const std::shared_ptr<Configuration> & configuration,
                            const std::shared_ptr<mem::Memory> & memory,
                            const std::shared_ptr<reg::RegisterManager> & registers,
-                           const std::shared_ptr<Interface> & interface)
+                           const std::shared_ptr<Frontend> & interface)
     : memory_(memory), registers_(registers), interface_(interface), configuration_(configuration) {
-  mt = std::mt19937(rd());
+  mt = std::mt19937(configuration->getSeed() != 0 ? configuration->getSeed() : rd());
   randbyte = std::make_unique<std::uniform_int_distribution<uint8_t>>(0, 255);
 }
 
+const std::mt19937 & Instructions::get_random() const {
+  return mt;
+}
+
+void Instructions::set_random(const std::mt19937 & random) {
+  mt = random;
+}
+
+void Instructions::set_speculative(bool speculative) {
+  speculative_ = speculative;
+}
+
 void Instructions::sys_0nnn(address_t addr) {}
 
 void Instructions::cls_00E0() {
-  interface_->clear();
+  interface_->display_->clear();
+  interface_->render();
 }
 
 void Instructions::ret_00EE() {
+  if (registers_->stack_.empty()) {
+    registers_->raise(Fault::stack_underflow);
+    return;
+  }
   registers_->pc_.poke(registers_->stack_.top());
   registers_->stack_.pop();
 }
 
+void Instructions::scd_00Cn(uint8_t n) {
+  interface_->display_->scroll_down(n);
+}
+
+void Instructions::scu_00Dn(uint8_t n) {
+  interface_->display_->scroll_up(n);
+}
+
+void Instructions::scr_00FB() {
+  interface_->display_->scroll_right(4);
+}
+
+void Instructions::scl_00FC() {
+  interface_->display_->scroll_left(4);
+}
+
+void Instructions::exit_00FD() {
+  registers_->exited_ = true;
+}
+
+void Instructions::low_00FE() {
+  interface_->display_->set_hires(false);
+}
+
+void Instructions::high_00FF() {
+  interface_->display_->set_hires(true);
+}
+
 void Instructions::jp_1nnn(address_t addr) {
   registers_->pc_.poke(addr);
 }
 
 void Instructions::call_2nnn(address_t addr) {
+  if (registers_->stack_.size() >= reg::RegisterManager::STACK_SIZE) {
+    registers_->raise(Fault::stack_overflow);
+    return;
+  }
   registers_->stack_.push(registers_->pc_.peek());
   registers_->pc_.poke(addr);
 }
 
 void Instructions::se_3xkk(regnb_t vx, uint8_t byte) {
-  if (registers_->v_[vx].peek() == byte) { registers_->pc_.increment(2); }
+  if (registers_->v_[vx].peek() == byte) { skip_next(); }
 }
 
 void Instructions::sne_4xkk(regnb_t vx, uint8_t byte) {
-  if (registers_->v_[vx].peek() != byte) { registers_->pc_.increment(2); }
+  if (registers_->v_[vx].peek() != byte) { skip_next(); }
 }
 
 void Instructions::se_5xy0(regnb_t vx, regnb_t vy) {
-  if (registers_->v_[vx].peek() == registers_->v_[vy].peek()) { registers_->pc_.increment(2); }
+  if (registers_->v_[vx].peek() == registers_->v_[vy].peek()) { skip_next(); }
+}
+
+void Instructions::ld_5xy2(regnb_t vx, regnb_t vy) {
+  if (!check_range(std::abs(vy - vx) + 1)) { return; }
+  int step = vx <= vy ? 1 : -1;
+  for (int i = 0; i <= std::abs(vy - vx); i++) {
+    memory_->poke(registers_->v_[vx + i * step].peek(), registers_->i_.peek() + i);
+  }
+}
+
+void Instructions::ld_5xy3(regnb_t vx, regnb_t vy) {
+  if (!check_range(std::abs(vy - vx) + 1)) { return; }
+  int step = vx <= vy ? 1 : -1;
+  for (int i = 0; i <= std::abs(vy - vx); i++) {
+    registers_->v_[vx + i * step].poke(memory_->peek(registers_->i_.peek() + i));
+  }
 }
 
 void Instructions::ld_6xkk(regnb_t vx, uint8_t byte) {
@@ -113,7 +178,7 @@ void Instructions::shl_8xyE(regnb_t vx, regnb_t vy) {
 }
 
 void Instructions::sne_9xy0(regnb_t vx, regnb_t vy) {
-  if (registers_->v_[vx].peek() != registers_->v_[vy].peek()) { registers_->pc_.increment(2); }
+  if (registers_->v_[vx].peek() != registers_->v_[vy].peek()) { skip_next(); }
 }
 
 void Instructions::ld_Annn(address_t addr) {
@@ -143,45 +208,39 @@ void Instructions::rnd_Cxkk(regnb_t vx, uint8_t byte) {
 
 /**
  * n is the height of the sprite.
- * sprites are 8 pixels (8 bytes) wide.
+ * sprites are 8 pixels (8 bytes) wide, or 16x16 when n is 0.
  * @param vx
  * @param vy
  * @param n
  */
 void Instructions::drw_Dxyn(regnb_t vx, regnb_t vy, uint8_t n) {
-  y_ = registers_->v_[vy].peek() % interface_->SIZE_Y_;
-  registers_->v_[0xf].poke(0);
-
-  for (int row = 0; row < n; row++) {
-    sprite_byte_ = memory_->peek(registers_->i_.peek() + row);
-    x_ = registers_->v_[vx].peek() % interface_->SIZE_X_;
-
-    for (uint8_t pixel = 0; pixel < 8; pixel++) {
-      if (x_ >= interface_->SIZE_X_) { x_ = 0; }
-      if (y_ >= interface_->SIZE_Y_) { y_ = 0; }
-
-      sprite_pixel_is_on_ = sprite_byte_ & (uint8_t) pow(2, 7 - pixel);
-      disp_pixel_is_on_ = interface_->is_pixel_on(x_, y_);
-
-      if (sprite_pixel_is_on_ && disp_pixel_is_on_) {
-        interface_->set_pixel_state(x_, y_, false);
-        registers_->v_[0xf].poke(1);
-      } else if (sprite_pixel_is_on_) {
-        interface_->set_pixel_state(x_, y_, true);
-      }
-      x_++;
+  uint8_t width = n == 0 ? 16 : 8;
+  uint8_t height = n == 0 ? 16 : n;
+
+  // Each selected plane reads its own sprite, following the previous one in memory.
+  uint8_t rows = height * __builtin_popcount(interface_->display_->get_planes());
+  if (!check_range(rows * width / 8)) { return; }
+
+  for (uint8_t row = 0; row < rows; row++) {
+    if (width == 16) {
+      sprite_[row] = (memory_->peek(registers_->i_.peek() + 2 * row) << 8) +
+                     memory_->peek(registers_->i_.peek() + 2 * row + 1);
+    } else {
+      sprite_[row] = memory_->peek(registers_->i_.peek() + row);
     }
-    y_++;
   }
+
+  registers_->v_[0xf].poke(interface_->display_->draw_sprite(
+          registers_->v_[vx].peek(), registers_->v_[vy].peek(), sprite_.data(), height, width));
   interface_->render();
 }
 
 void Instructions::skp_Ex9E(regnb_t vx) {
-  if (interface_->is_pressed(registers_->v_[vx].peek())) { registers_->pc_.increment(2); }
+  if (interface_->is_pressed(registers_->v_[vx].peek())) { skip_next(); }
 }
 
 void Instructions::sknp_ExA1(regnb_t vx) {
-  if (!interface_->is_pressed(registers_->v_[vx].peek())) { registers_->pc_.increment(2); }
+  if (!interface_->is_pressed(registers_->v_[vx].peek())) { skip_next(); }
 }
 
 void Instructions::ld_Fx07(regnb_t vx) {
@@ -189,11 +248,20 @@ void Instructions::ld_Fx07(regnb_t vx) {
 }
 
 void Instructions::ld_Fx0A(regnb_t vx) {
-  if (interface_->get_any_pressed() != 0x10) {
-    registers_->v_[vx].poke(interface_->get_any_pressed());
-    return;
-  }
-  registers_->pc_.decrement(2);
+  registers_->halted_ = true;
+  registers_->key_register_ = vx;
+  resume_Fx0A();
+}
+
+bool Instructions::resume_Fx0A() {
+  if (!registers_->halted_) { return true; }
+
+  uint8_t key = interface_->get_any_pressed();
+  if (key == 0x10) { return false; }
+
+  registers_->v_[registers_->key_register_].poke(key);
+  registers_->halted_ = false;
+  return true;
 }
 
 void Instructions::ld_Fx15(regnb_t vx) {
@@ -201,9 +269,32 @@ void Instructions::ld_Fx15(regnb_t vx) {
 }
 
 void Instructions::ld_Fx18(regnb_t vx) {
+  if (registers_->st_.peek() == 0 && registers_->v_[vx].peek() > 0 && !speculative_) {
+    interface_->mark_beep_request();
+  }
   registers_->st_.poke(registers_->v_[vx].peek());
 }
 
+void Instructions::ld_F000(address_t addr) {
+  registers_->i_.poke(addr);
+}
+
+void Instructions::plane_Fn01(uint8_t n) {
+  interface_->display_->select_planes(n);
+}
+
+void Instructions::audio_F002() {
+  if (!check_range(registers_->audio_pattern_.size())) { return; }
+  for (uint8_t i = 0; i < registers_->audio_pattern_.size(); i++) {
+    registers_->audio_pattern_[i] = memory_->peek(registers_->i_.peek() + i);
+  }
+  registers_->audio_pattern_loaded_ = true;
+}
+
+void Instructions::pitch_Fx3A(regnb_t vx) {
+  registers_->pitch_ = registers_->v_[vx].peek();
+}
+
 /**
  * @param vx
  */
@@ -217,7 +308,12 @@ void Instructions::ld_Fx29(regnb_t vx) {
   registers_->i_.poke((registers_->v_[vx].peek() & 0xf) * 5);
 }
 
+void Instructions::ld_Fx30(regnb_t vx) {
+  registers_->i_.poke(memory_->FONT_.size() + (registers_->v_[vx].peek() & 0xf) * 10);
+}
+
 void Instructions::ld_Fx33(regnb_t vx) {
+  if (!check_range(3)) { return; }
   memory_->poke(registers_->v_[vx].peek() / 100 % 10, registers_->i_.peek());
   memory_->poke(registers_->v_[vx].peek() / 10 % 10, registers_->i_.peek() + 1);
   memory_->poke(registers_->v_[vx].peek() % 10, registers_->i_.peek() + 2);
@@ -228,6 +324,7 @@ void Instructions::ld_Fx33(regnb_t vx) {
  * @param vx
  */
 void Instructions::ld_Fx55(regnb_t vx) {
+  if (!check_range(vx + 1)) { return; }
   for (int i = 0; i <= vx; i++) {
     if (configuration_->isCFx55Fx65IncrementsI()) {
       memory_->poke(registers_->v_[i].peek(), registers_->i_.peek());
@@ -243,6 +340,7 @@ void Instructions::ld_Fx55(regnb_t vx) {
  * @param vx
  */
 void Instructions::ld_Fx65(regnb_t vx) {
+  if (!check_range(vx + 1)) { return; }
   for (int i = 0; i <= vx; i++) {
     if (configuration_->isCFx55Fx65IncrementsI()) {
       registers_->v_[i].poke(memory_->peek(registers_->i_.peek()));
@@ -252,3 +350,54 @@ void Instructions::ld_Fx65(regnb_t vx) {
     }
   }
 }
+
+void Instructions::ld_Fx75(regnb_t vx) {
+  for (int i = 0; i <= vx; i++) { registers_->rpl_[i] = registers_->v_[i].peek(); }
+}
+
+void Instructions::ld_Fx85(regnb_t vx) {
+  for (int i = 0; i <= vx; i++) { registers_->v_[i].poke(registers_->rpl_[i]); }
+}
+
+void Instructions::ld_drw_Annn_Dxyn(address_t addr, regnb_t vx, regnb_t vy, uint8_t n) {
+  ld_Annn(addr);
+  drw_Dxyn(vx, vy, n);
+}
+
+void Instructions::ld_ld_6xkk_Fx15(regnb_t vx, uint8_t byte) {
+  registers_->v_[vx].poke(byte);
+  registers_->dt_.poke(byte);
+}
+
+void Instructions::add_se_7xkk_3xkk(regnb_t vx, uint8_t add, uint8_t cmp) {
+  registers_->v_[vx].poke(registers_->v_[vx].peek() + add);
+  if (registers_->v_[vx].peek() == cmp) { skip_next(); }
+}
+
+void Instructions::add_sne_7xkk_4xkk(regnb_t vx, uint8_t add, uint8_t cmp) {
+  registers_->v_[vx].poke(registers_->v_[vx].peek() + add);
+  if (registers_->v_[vx].peek() != cmp) { skip_next(); }
+}
+
+bool Instructions::ld_se_jp_Fx07_3xkk_1nnn(regnb_t vx, uint8_t byte, address_t addr) {
+  registers_->v_[vx].poke(registers_->dt_.peek());
+  if (registers_->v_[vx].peek() == byte) {
+    registers_->pc_.increment(2);
+    return false;
+  }
+  registers_->pc_.poke(addr);
+  return true;
+}
+
+bool Instructions::check_range(unsigned int size) {
+  if (registers_->i_.peek() + size <= MEMORY_SIZE) { return true; }
+  registers_->raise(Fault::address_out_of_range);
+  return false;
+}
+
+void Instructions::skip_next() {
+  address_t pc = registers_->pc_.peek();
+  bool long_load = static_cast<unsigned int>(pc) + 1 < MEMORY_SIZE && memory_->peek(pc) == 0xF0 &&
+                   memory_->peek(pc + 1) == 0x00;
+  registers_->pc_.increment(long_load ? 4 : 2);
+}
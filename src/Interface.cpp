@@ -3,177 +3,283 @@
 
 #include "Interface.h"
 
-Interface::Interface(const std::shared_ptr<reg::RegisterManager> & registers, bool hidden)
-    : registers_(registers) {
+Interface::Interface(const std::shared_ptr<reg::RegisterManager> & registers, bool hidden,
+                     int sample_rate, int buffer_samples)
+    : registers_(registers), hidden_(hidden) {
 
-  if (SDL_Init(SDL_INIT_AUDIO != 0) || SDL_Init(SDL_INIT_VIDEO) != 0) {
+  if (SDL_Init(SDL_INIT_VIDEO) != 0) {
     throw std::runtime_error("Unable to initialize rendering engine.");
   }
-
-  SDL_zero(want_);
-  want_.freq = SAMPLE_RATE;
-  want_.format = AUDIO_S16SYS;
-  want_.channels = 1;
-  want_.samples = 100;
-  want_.callback = Interface::forward_audio_callback;
-  want_.userdata = &sound_userdata_;
-
-  if (SDL_OpenAudio(&want_, &have_) != 0) {
-    SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "Failed to open audio: %s", SDL_GetError());
-  }
-  if (want_.format != have_.format) {
-    SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "Failed to get the desired AudioSpec");
-  }
+  open_audio(sample_rate, buffer_samples);
 
   window = SDL_CreateWindow("CHIP8", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
-                            SIZE_X_ * SIZE_MULTIPLIER_, SIZE_Y_ * SIZE_MULTIPLIER_,
+                            Display::MAX_SIZE_X / 2 * SIZE_MULTIPLIER_,
+                            Display::MAX_SIZE_Y / 2 * SIZE_MULTIPLIER_,
                             hidden ? SDL_WINDOW_HIDDEN : 0);
 
   renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
-  bpp_ = SDL_GetWindowSurface(window)->format->BytesPerPixel;
+  texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                               Display::MAX_SIZE_X, Display::MAX_SIZE_Y);
+  set_keymap(DEFAULT_KEYMAP);
   SDL_Delay(1000);
 }
 
 Interface::~Interface() {
-  SDL_CloseAudio();
+  if (audio_device_ != 0) { SDL_CloseAudioDevice(audio_device_); }
+  SDL_DestroyTexture(texture_);
+  SDL_DestroyRenderer(renderer);
   SDL_DestroyWindow(window);
   SDL_Quit();
 }
 
 void Interface::poll_events() {
-  SDL_PollEvent(&events_);
+  while (SDL_PollEvent(&events_)) { handle_event(events_); }
+}
+
+void Interface::wait_events(int timeout) {
+  if (SDL_WaitEventTimeout(&events_, timeout)) {
+    handle_event(events_);
+    poll_events();
+  }
 }
 
 bool Interface::requests_close() const {
-  return events_.type == SDL_WINDOWEVENT && events_.window.event == SDL_WINDOWEVENT_CLOSE;
+  return close_requested_;
 }
 
-void Interface::clear() {
-  for (u_int8_t x = 0; x < SIZE_X_; x++) {
-    for (u_int8_t y = 0; y < SIZE_Y_; y++) { set_pixel_state(x, y, false); }
+void Interface::set_keymap(const std::string & layout) {
+  if (layout.size() != 0x10) {
+    throw std::runtime_error("Keymap must bind exactly 16 keys: " + layout);
   }
-  render();
-}
 
-void Interface::set_pixel_state(unsigned short x, unsigned short y, bool state) {
-  screen_memory_[x][y] = state;
+  // Left unchanged by an invalid layout
+  std::array<uint8_t, SDL_NUM_SCANCODES> keymap;
+  keymap.fill(0x10);
+  for (uint8_t key = 0; key < 0x10; key++) {
+    SDL_Scancode scancode = SDL_GetScancodeFromName(std::string(1, layout[key]).c_str());
+    if (scancode == SDL_SCANCODE_UNKNOWN) {
+      throw std::runtime_error("Unknown key in keymap: " + std::string(1, layout[key]));
+    }
+    // Another keypad key would be left unbound
+    if (keymap[scancode] != 0x10) {
+      throw std::runtime_error("Key bound twice in keymap: " + std::string(1, layout[key]));
+    }
+    keymap[scancode] = key;
+  }
+  keymap_ = keymap;
 }
 
-void Interface::draw_pixel(unsigned short x, unsigned short y, bool state) {
-  if (state) {
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
-  } else {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+void Interface::handle_event(const SDL_Event & event) {
+  switch (event.type) {
+    case SDL_QUIT:
+      close_requested_ = true;
+      return;
+    case SDL_WINDOWEVENT:
+      close_requested_ |= event.window.event == SDL_WINDOWEVENT_CLOSE;
+      return;
+    case SDL_KEYDOWN:
+      if (keymap_[event.key.keysym.scancode] != 0x10) {
+        input_.press(keymap_[event.key.keysym.scancode]);
+      }
+      return;
+    case SDL_KEYUP:
+      if (keymap_[event.key.keysym.scancode] != 0x10) {
+        input_.release(keymap_[event.key.keysym.scancode]);
+      }
+      return;
   }
-  SDL_Rect rect = {normalize_x(x), normalize_y(y), SIZE_MULTIPLIER_, SIZE_MULTIPLIER_};
-  SDL_RenderFillRect(renderer, &rect);
 }
 
-void Interface::render() {
-  for (u_int8_t x = 0; x < SIZE_X_; x++) {
-    for (u_int8_t y = 0; y < SIZE_Y_; y++) { draw_pixel(x, y, screen_memory_[x][y]); }
+uint16_t Interface::get_input() const {
+  return input_.get_mask();
+}
+
+void Interface::present(const Display & display) {
+  if (hidden_) { return; }
+
+  void * pixels;
+  int pitch;
+  if (SDL_LockTexture(texture_, nullptr, &pixels, &pitch) != 0) { return; }
+
+  std::array<Display::row_t, Display::PLANES> rows;
+  for (unsigned short int y = 0; y < display.size_y(); y++) {
+    for (uint8_t p = 0; p < Display::PLANES; p++) { rows[p] = display.get_row(y, p); }
+    Uint32 * line = reinterpret_cast<Uint32 *>(static_cast<Uint8 *>(pixels) + y * pitch);
+
+    // The planes are composited into a palette index, one bit each.
+    for (unsigned short int x = 0; x < display.size_x(); x++) {
+      uint8_t color = 0;
+      for (uint8_t p = 0; p < Display::PLANES; p++) {
+        color |= (rows[p] >> (Display::MAX_SIZE_X - 1)) << p;
+        rows[p] <<= 1;
+      }
+      line[x] = PALETTE[color];
+    }
   }
+  SDL_UnlockTexture(texture_);
+
+  // The texture is stretched to the window, whatever the resolution.
+  SDL_Rect source = {0, 0, display.size_x(), display.size_y()};
+  SDL_RenderCopy(renderer, texture_, &source, nullptr);
   SDL_RenderPresent(renderer);
 }
 
-bool Interface::is_pixel_on(int x, int y) {
-  if (x >= SIZE_X_ || y >= SIZE_Y_) {
-    throw std::runtime_error("Tried to get the value of an out of bound pixel.");
-  }
-  return screen_memory_[x][y];
-}
-
-void Interface::get_keys() {
-  key_state_ = SDL_GetKeyboardState(NULL);
-}
-
-bool Interface::is_pressed(uint8_t key) const {
-  switch (key) {
-    case 0x1:
-      return key_state_[SDL_SCANCODE_1];
-    case 0x2:
-      return key_state_[SDL_SCANCODE_2];
-    case 0x3:
-      return key_state_[SDL_SCANCODE_3];
-    case 0xc:
-      return key_state_[SDL_SCANCODE_4];
-    case 0x4:
-      return key_state_[SDL_SCANCODE_Q];
-    case 0x5:
-      return key_state_[SDL_SCANCODE_W];
-    case 0x6:
-      return key_state_[SDL_SCANCODE_E];
-    case 0xd:
-      return key_state_[SDL_SCANCODE_R];
-    case 0x7:
-      return key_state_[SDL_SCANCODE_A];
-    case 0x8:
-      return key_state_[SDL_SCANCODE_S];
-    case 0x9:
-      return key_state_[SDL_SCANCODE_D];
-    case 0xe:
-      return key_state_[SDL_SCANCODE_F];
-    case 0xa:
-      return key_state_[SDL_SCANCODE_Z];
-    case 0x0:
-      return key_state_[SDL_SCANCODE_X];
-    case 0xb:
-      return key_state_[SDL_SCANCODE_C];
-    case 0xf:
-      return key_state_[SDL_SCANCODE_V];
-    default:
-      return false;
-  }
-}
-
-uint8_t Interface::get_any_pressed() const {
-  if (key_state_[SDL_SCANCODE_1]) { return 0x1; }
-  if (key_state_[SDL_SCANCODE_2]) { return 0x2; }
-  if (key_state_[SDL_SCANCODE_3]) { return 0x3; }
-  if (key_state_[SDL_SCANCODE_4]) { return 0xc; }
-  if (key_state_[SDL_SCANCODE_Q]) { return 0x4; }
-  if (key_state_[SDL_SCANCODE_W]) { return 0x5; }
-  if (key_state_[SDL_SCANCODE_E]) { return 0x6; }
-  if (key_state_[SDL_SCANCODE_R]) { return 0xd; }
-  if (key_state_[SDL_SCANCODE_A]) { return 0x7; }
-  if (key_state_[SDL_SCANCODE_S]) { return 0x8; }
-  if (key_state_[SDL_SCANCODE_D]) { return 0x9; }
-  if (key_state_[SDL_SCANCODE_F]) { return 0xe; }
-  if (key_state_[SDL_SCANCODE_Z]) { return 0xa; }
-  if (key_state_[SDL_SCANCODE_X]) { return 0x0; }
-  if (key_state_[SDL_SCANCODE_C]) { return 0xb; }
-  if (key_state_[SDL_SCANCODE_V]) { return 0xf; }
-  return 0x10;
-}
-
-unsigned short int Interface::normalize_x(unsigned short int x) const {
-  return (x % SIZE_X_) * SIZE_MULTIPLIER_;
-}
-
-unsigned short int Interface::normalize_y(unsigned short int y) const {
-  return (y % SIZE_Y_) * SIZE_MULTIPLIER_;
-}
-
-void Interface::audio_callback(void * user_data, Uint8 * raw_buffer, int bytes) {
-  audio_buffer_ = reinterpret_cast<Sint16 *>(raw_buffer);
-  sample_length_ = bytes / 2;// 2 bytes per sample for AUDIO_S16SYS
-  int & sample_nr(*(int *) user_data);
-
-  for (int i = 0; i < sample_length_; i++, sample_nr++) {
-    double time = (double) sample_nr / (double) SAMPLE_RATE;
-    audio_buffer_[i] = static_cast<Sint16>(
-            AMPLITUDE * (2 * (2 * floor(220.0f * time) - floor(2 * 220.0f * time)) + 1));
+void Interface::open_audio(int sample_rate, int buffer_samples) {
+  SDL_zero(have_);
+  SDL_zero(want_);
+  want_.freq = sample_rate;
+  want_.format = AUDIO_S16SYS;
+  want_.channels = 1;
+  want_.samples = buffer_samples;
+  want_.callback = Interface::forward_audio_callback;
+  want_.userdata = this;
+
+  if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
+    SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "Failed to initialize audio: %s", SDL_GetError());
+    return;
+  }
+
+  // Let SDL convert the format, but use the rate and buffer size of the device as is.
+  audio_device_ = SDL_OpenAudioDevice(
+          nullptr, 0, &want_, &have_,
+          SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+  if (audio_device_ == 0) {
+    SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "Failed to open audio: %s", SDL_GetError());
+    return;
+  }
+  if (have_.freq != want_.freq || have_.samples != want_.samples) {
+    SDL_LogInfo(SDL_LOG_CATEGORY_AUDIO, "Audio opened at %d Hz with %d samples buffers",
+                have_.freq, have_.samples);
+  }
+
+  buffer_period_ = SDL_GetPerformanceFrequency() * have_.samples / have_.freq;
+  build_wavetable(have_.freq);
+}
+
+void Interface::build_wavetable(int sample_rate) {
+  for (int i = 0; i < WAVETABLE_SIZE; i++) {
+    double sample = 0;
+    for (int harmonic = 1; harmonic * TONE_FREQUENCY < sample_rate / 2.; harmonic += 2) {
+      sample += sin(2 * M_PI * harmonic * i / WAVETABLE_SIZE) / harmonic;
+    }
+    wavetable_[i] = static_cast<Sint16>(AMPLITUDE * 4 / M_PI * sample);
+  }
+  phase_increment_ = static_cast<uint32_t>(TONE_FREQUENCY / sample_rate * 4294967296.);
+}
+
+void Interface::measure_callback(Uint64 now) {
+  callbacks_++;
+
+  unsigned long epoch = audio_epoch_.load(std::memory_order_acquire);
+  if (epoch != callback_epoch_ || last_callback_ == 0) {
+    callback_epoch_ = epoch;
+    last_callback_ = now;
+    return;
+  }
+
+  Uint64 period = now - last_callback_;
+  last_callback_ = now;
+
+  if (period > 2 * buffer_period_) { underruns_++; }
+
+  Uint64 jitter = period > buffer_period_ ? period - buffer_period_ : buffer_period_ - period;
+  jitter_count_++;
+  jitter_sum_ += jitter;
+  if (jitter > jitter_max_) { jitter_max_ = jitter; }
+}
+
+void Interface::audio_callback(Uint8 * raw_buffer, int bytes) {
+  Uint64 now = SDL_GetPerformanceCounter();
+  measure_callback(now);
+
+  Sint16 * buffer = reinterpret_cast<Sint16 *>(raw_buffer);
+  int samples = bytes / 2;// 2 bytes per sample for AUDIO_S16SYS
+
+  if (!buzzer_on_.load(std::memory_order_relaxed)) {
+    std::fill(buffer, buffer + samples, 0);
+    return;
+  }
+
+  Uint64 requested = beep_requested_at_.exchange(0);
+  if (requested != 0) {
+    beeps_++;
+    onset_sum_ += now - requested;
+    if (now - requested > onset_max_) { onset_max_ = now - requested; }
+  }
+
+  if (pattern_on_.load(std::memory_order_relaxed)) {
+    uint64_t pattern[2] = {pattern_[0].load(std::memory_order_relaxed),
+                           pattern_[1].load(std::memory_order_relaxed)};
+    uint32_t increment = pattern_increment_.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < samples; i++, pattern_phase_ += increment) {
+      uint8_t bit = pattern_phase_ >> (32 - PATTERN_BITS);
+      buffer[i] = (pattern[bit >> 6] >> (63 - (bit & 63))) & 0x1 ? AMPLITUDE : -AMPLITUDE;
+    }
+    return;
+  }
+
+  for (int i = 0; i < samples; i++, phase_ += phase_increment_) {
+    buffer[i] = wavetable_[phase_ >> (32 - WAVETABLE_BITS)];
   }
 }
 
 void Interface::forward_audio_callback(void * user_data, Uint8 * raw_buffer, int bytes) {
-  static_cast<Interface *>(user_data)->audio_callback(user_data, raw_buffer, bytes);
+  static_cast<Interface *>(user_data)->audio_callback(raw_buffer, bytes);
 }
 
 void Interface::toogle_buzzer() {
-  if (registers_->st_.peek() > 0) {
-    SDL_PauseAudio(0);
-  } else {
-    SDL_PauseAudio(1);
+  if (registers_->audio_pattern_loaded_) { update_pattern(); }
+
+  bool on = registers_->st_.peek() > 0;
+  // A beep that ended before it could be heard is not measured.
+  if (!on) { beep_requested_at_.store(0); }
+  if (buzzer_on_.exchange(on, std::memory_order_relaxed) == on || audio_device_ == 0) { return; }
+
+  if (on) { audio_epoch_.fetch_add(1, std::memory_order_release); }
+  SDL_PauseAudioDevice(audio_device_, on ? 0 : 1);
+}
+
+uint32_t Interface::get_pattern_increment(uint8_t pitch, int sample_rate) {
+  double rate = PATTERN_RATE * std::pow(2., (pitch - 64) / 48.);
+  return static_cast<uint32_t>(rate / sample_rate * (4294967296. / (1 << PATTERN_BITS)));
+}
+
+void Interface::update_pattern() {
+  if (audio_device_ == 0) { return; }
+
+  for (uint8_t word = 0; word < pattern_.size(); word++) {
+    uint64_t bits = 0;
+    for (uint8_t i = 0; i < 8; i++) { bits = bits << 8 | registers_->audio_pattern_[word * 8 + i]; }
+    pattern_[word].store(bits, std::memory_order_relaxed);
   }
-}
\ No newline at end of file
+
+  if (registers_->pitch_ != pattern_pitch_) {
+    pattern_pitch_ = registers_->pitch_;
+    pattern_increment_.store(get_pattern_increment(registers_->pitch_, have_.freq),
+                             std::memory_order_relaxed);
+  }
+  pattern_on_.store(true, std::memory_order_relaxed);
+}
+
+void Interface::mark_beep_request() {
+  Uint64 none = 0;
+  beep_requested_at_.compare_exchange_strong(none, SDL_GetPerformanceCounter());
+}
+
+AudioStats Interface::get_audio_stats() const {
+  double ms = 1000. / SDL_GetPerformanceFrequency();
+  return AudioStats{have_.freq,
+                    have_.samples,
+                    callbacks_,
+                    underruns_,
+                    jitter_count_ ? jitter_sum_ * ms / jitter_count_ : 0,
+                    jitter_max_ * ms,
+                    beeps_,
+                    beeps_ ? onset_sum_ * ms / beeps_ : 0,
+                    onset_max_ * ms};
+}
+
+bool Interface::is_buzzing() const {
+  return buzzer_on_.load(std::memory_order_relaxed);
+}
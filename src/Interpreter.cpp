@@ -5,6 +5,8 @@
 
 volatile static sig_atomic_t stop = 0;
 const unsigned short int FREQ = 500;
+// Longest wait for SDL events, in milliseconds, so published frames are presented promptly
+const int EVENT_TIMEOUT = 4;
 
 using namespace std::chrono;
 
@@ -13,38 +15,162 @@ void inthand(int signum) {
 }
 
 Interpreter::Interpreter(std::shared_ptr<Configuration> configuration)
-    : configuration_(configuration) {
+    : configuration_(configuration),
+      registers_(std::make_shared<reg::RegisterManager>(configuration->getFrequency())),
+      interface_(std::make_shared<Interface>(registers_, false,
+                                             configuration->getAudioSampleRate(),
+                                             configuration->getAudioBufferSamples())),
+      machine_(configuration, registers_, interface_), pacer_(configuration->getMaxFrameskip()) {
   signal(SIGINT, inthand);
   signal(SIGTERM, inthand);
 
-  memory_ = std::make_shared<mem::Memory>();
-  registers_ = std::make_shared<reg::RegisterManager>(configuration->getFrequency());
-  interface_ = std::make_shared<Interface>(registers_);
-  instructions_ = std::make_shared<Instructions>(configuration, memory_, registers_, interface_);
-  romParser_ = std::make_shared<RomParser>(configuration, memory_, registers_, instructions_);
+  interface_->set_keymap(configuration->getKeymap());
+  if (!configuration->getExportName().empty()) {
+    export_ = std::make_unique<FrameExport>(configuration->getExportName());
+  }
+  if (!configuration->getVideoPath().empty()) {
+    video_ = std::make_unique<VideoWriter>(configuration->getVideoPath());
+  }
 }
 
 void Interpreter::loop() {
+  std::thread core(&Interpreter::run_core, this);
+  uint16_t keys = 0x0;
+  bool exited = false;
+
+  // The SDL thread only handles events and presents the frames published by the core.
+  while (!stop && !exited) {
+    interface_->wait_events(EVENT_TIMEOUT);
+    uint16_t input = interface_->get_input();
+    if (input != keys && inputs_.push({input, false})) {
+      keys = input;
+    }
+
+    unsigned int received = 0;
+    while (frames_.pop(frame_)) {
+      received++;
+      exited = exited || frame_.exited;
+    }
+    // Only the latest frame is presented
+    if (received > 0) {
+      interface_->present(frame_.display);
+      superseded_frames_ += received - 1;
+    }
 
-  const milliseconds intervalPeriodMillis{
-          static_cast<int>((1. / configuration_->getFrequency()) * 1000)};
+    stop = stop || interface_->requests_close();
+  }
 
-  //Initialize the chrono timepoint & duration objects we'll be using over & over inside our sleep loop
-  system_clock::time_point currentStartTime{system_clock::now()};
-  system_clock::time_point nextStartTime{currentStartTime};
+  while (!inputs_.push({keys, true})) { std::this_thread::yield(); }
+  core.join();
 
-  while (!stop) {
-    currentStartTime = system_clock::now();
-    nextStartTime = currentStartTime + intervalPeriodMillis;
+  print_audio_stats();
+  print_fusion_stats();
+  print_frame_stats();
+  if (video_) { video_->finish(); }
+  print_video_stats();
+  if (!registers_->faulted_ && registers_->faults_ > 0) {
+    std::cout << "Ignored " << registers_->faults_ << " faults, the last one: ";
+    print_fault();
+  }
+}
 
-    registers_->trigger_timers();
+void Interpreter::run_core() {
+  const microseconds intervalPeriod{1000000 / configuration_->getFrequency()};
+  const unsigned int run_ahead = configuration_->getRunAhead();
+  Input input{};
+  // The first frame is published even if the program does not draw
+  bool publish = true;
+  bool exit_published = false;
+
+  for (;;) {
+    // A frame runs the CPU up to the next timer tick, input is sampled once at its start.
+    unsigned short int cycles =
+            std::max<unsigned short int>(registers_->cycles_to_next_tick(), 1);
+    FramePacer::clock::time_point deadline =
+            pacer_.begin(intervalPeriod * cycles, FramePacer::clock::now());
+
+    while (inputs_.pop(input)) {
+      if (input.quit) { return; }
+      interface_->keypad_->set_mask(input.keys);
+    }
+
+    unsigned long faults = registers_->faults_;
+    machine_.romParser_->run(cycles);
     interface_->toogle_buzzer();
-    interface_->poll_events();
-    interface_->get_keys();
-    romParser_->step();
-    romParser_->decode();
+    pacer_.end(FramePacer::clock::now());
+    if (export_) { export_->publish(machine_, pacer_.get_stats()); }
+    if (video_) { video_->push(*interface_->display_); }
 
-    stop = stop || interface_->requests_close();
-    std::this_thread::sleep_until(nextStartTime);
+    if (registers_->faulted_ && registers_->faults_ != faults) {
+      // Halted by a fault: the last frame stays displayed until the window is closed.
+      print_fault();
+    }
+
+    // A frame skipped to catch up, or that does not fit in the queue, is published with the next
+    // one. Frames ahead may draw even if this one did not, so they are published every period.
+    publish = interface_->take_render_request() || publish || run_ahead > 0;
+    bool exiting = registers_->exited_ && !exit_published;
+    if (exiting || (publish && pacer_.should_present())) {
+      Frame frame{*interface_->display_, registers_->exited_};
+      if (run_ahead > 0 && !registers_->exited_) {
+        frame.display = machine_.run_ahead(run_ahead);
+        interface_->take_render_request();
+      }
+      if (frames_.push(frame)) {
+        pacer_.mark_presented();
+        publish = false;
+        exit_published = registers_->exited_;
+      }
+    }
+
+    std::this_thread::sleep_until(deadline);
   }
 }
+
+void Interpreter::print_audio_stats() const {
+  AudioStats stats = interface_->get_audio_stats();
+  if (stats.callbacks == 0) { return; }
+
+  std::cout << "Audio: " << stats.sample_rate << " Hz, " << stats.buffer_samples
+            << " samples buffers, " << stats.callbacks << " callbacks, " << stats.underruns
+            << " underruns\n"
+            << "Audio callback jitter: mean " << stats.mean_jitter << " ms, max "
+            << stats.max_jitter << " ms\n"
+            << "Beep onset latency over " << stats.beeps << " beeps: mean "
+            << stats.mean_onset_latency << " ms, max " << stats.max_onset_latency << " ms\n";
+}
+
+void Interpreter::print_fusion_stats() const {
+  const FusionStats & stats = machine_.romParser_->get_fusion_stats();
+  if (stats.dispatches == 0) { return; }
+
+  std::cout << "Dispatches: " << stats.dispatches << " for " << stats.instructions
+            << " instructions (" << 100. * stats.dispatches / stats.instructions << "%)\n";
+  for (size_t i = 0; i < stats.fused.size(); i++) {
+    std::cout << "Superinstruction " << op::FUSION_NAMES[i] << ": " << stats.fused[i] << "\n";
+  }
+}
+
+void Interpreter::print_fault() const {
+  std::cout << "Fault: " << FAULT_NAMES[static_cast<size_t>(registers_->fault_)]
+            << " at 0x"
+            << std::hex << registers_->fault_address_ << std::dec << "\n";
+}
+
+void Interpreter::print_frame_stats() const {
+  const FrameStats & stats = pacer_.get_stats();
+  if (stats.late == 0 && superseded_frames_ == 0) { return; }
+
+  std::cout << "Frames: " << stats.frames << " periods, " << stats.late << " late (max "
+            << stats.max_lateness << " ms), " << stats.presented << " presented, " << stats.skipped
+            << " skipped, " << superseded_frames_ << " superseded, " << stats.resyncs
+            << " resyncs\n";
+}
+
+void Interpreter::print_video_stats() const {
+  if (!video_) { return; }
+
+  VideoStats stats = video_->get_stats();
+  std::cout << "Video: " << stats.written << " frames written, " << stats.dropped
+            << " dropped\n";
+}
@@ -0,0 +1,29 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Keypad.h"
+
+bool Keypad::is_pressed(uint8_t key) const {
+  return key < 0x10 && (mask_ >> key) & 0x1;
+}
+
+uint8_t Keypad::get_any_pressed() const {
+  if (mask_ == 0x0) { return 0x10; }
+  return __builtin_ctz(mask_);
+}
+
+void Keypad::press(uint8_t key) {
+  mask_ |= 0x1 << (key & 0xF);
+}
+
+void Keypad::release(uint8_t key) {
+  mask_ &= ~(0x1 << (key & 0xF));
+}
+
+uint16_t Keypad::get_mask() const {
+  return mask_;
+}
+
+void Keypad::set_mask(uint16_t mask) {
+  mask_ = mask;
+}
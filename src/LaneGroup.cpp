@@ -0,0 +1,262 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "LaneGroup.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+  using signed_bytes_t = int8_t __attribute__((vector_size(LaneGroup::LANES)));
+  using signed_words_t = int16_t __attribute__((vector_size(LaneGroup::LANES * 2)));
+
+  LaneGroup::bytes_t select(LaneGroup::bytes_t mask, LaneGroup::bytes_t a,
+                            LaneGroup::bytes_t b) {
+    return (a & mask) | (b & ~mask);
+  }
+
+  // Words are passed by reference: by value, their ABI depends on AVX being enabled
+  void assign(LaneGroup::words_t & target, const LaneGroup::words_t & mask,
+              const LaneGroup::words_t & value) {
+    target = (value & mask) | (target & ~mask);
+  }
+}// namespace
+
+LaneGroup::LaneGroup(const std::vector<Machine *> & machines) : machines_(machines) {
+  if (machines.empty() || machines.size() > LANES) {
+    throw std::runtime_error("A lane group holds 1 to 16 machines.");
+  }
+  for (unsigned int lane = 0; lane < machines_.size(); lane++) {
+    memories_[lane] = machines_[lane]->memory_.get();
+  }
+
+  const Configuration & configuration = *machines_[0]->configuration_;
+  shift_sets_vy_ = configuration.isC8Xy68XyESetsVy();
+  logic_resets_vf_ = configuration.isC8Xy18Xy28Xy3ResetVf();
+  jump_uses_vx_ = configuration.isCBnnnBecomesBxnn();
+}
+
+void LaneGroup::run_frame() {
+  for (unsigned int lane = 0; lane < machines_.size(); lane++) {
+    const reg::RegisterManager & registers = *machines_[lane]->registers_;
+    remaining_[lane] = std::max<unsigned int>(registers.cycles_to_next_tick(), 1);
+    gather(lane);
+    settle(lane);
+  }
+
+  for (;;) {
+    unsigned int leader = mem::MEMORY_SIZE;
+    for (unsigned int lane = 0; lane < machines_.size(); lane++) {
+      if (remaining_[lane] > 0) { leader = std::min<unsigned int>(leader, pc_[lane]); }
+    }
+    if (leader == mem::MEMORY_SIZE) { break; }
+
+    bytes_t mask{};
+    for (unsigned int lane = 0; lane < machines_.size(); lane++) {
+      if (remaining_[lane] > 0 && pc_[lane] == leader) { mask[lane] = 0xFF; }
+    }
+
+    // The fetch is checked by the interpreter, as well as lanes whose memory differs.
+    bool uniform = leader + 1 < mem::MEMORY_SIZE;
+    op::opcode_t opcode = 0x0;
+    unsigned int lanes = 0;
+    for (unsigned int lane = 0; uniform && lane < machines_.size(); lane++) {
+      if (!mask[lane]) { continue; }
+      const mem::Memory & memory = *memories_[lane];
+      op::opcode_t lane_opcode = (memory.peek(leader) << 8) + memory.peek(leader + 1);
+      uniform = lanes == 0 || lane_opcode == opcode;
+      opcode = lane_opcode;
+      lanes++;
+    }
+
+    if (uniform && is_lane_wise(opcode)) {
+      execute(opcode, mask);
+      for (unsigned int lane = 0; lane < machines_.size(); lane++) {
+        if (!mask[lane]) { continue; }
+        remaining_[lane]--;
+        used_[lane]++;
+      }
+      stats_.vector++;
+      stats_.lanes += lanes;
+    } else {
+      for (unsigned int lane = 0; lane < machines_.size(); lane++) {
+        if (mask[lane]) { run_scalar(lane); }
+      }
+    }
+  }
+
+  for (unsigned int lane = 0; lane < machines_.size(); lane++) { scatter(lane); }
+}
+
+const LaneStats & LaneGroup::get_stats() const {
+  return stats_;
+}
+
+void LaneGroup::gather(unsigned int lane) {
+  reg::RegisterManager & registers = *machines_[lane]->registers_;
+  for (uint8_t v = 0; v < 0x10; v++) { v_[v][lane] = registers.v_[v].peek(); }
+  i_[lane] = registers.i_.peek();
+  pc_[lane] = registers.pc_.peek();
+}
+
+void LaneGroup::scatter(unsigned int lane) {
+  reg::RegisterManager & registers = *machines_[lane]->registers_;
+  for (uint8_t v = 0; v < 0x10; v++) { registers.v_[v].poke(v_[v][lane]); }
+  registers.i_.poke(i_[lane]);
+  registers.pc_.poke(pc_[lane]);
+  registers.elapse(used_[lane]);
+  used_[lane] = 0;
+}
+
+void LaneGroup::settle(unsigned int lane) {
+  const reg::RegisterManager & registers = *machines_[lane]->registers_;
+  if (registers.exited_ || registers.faulted_) {
+    remaining_[lane] = 0;
+  } else if (registers.halted_) {
+    // Waits for a key, or runs the rest of the frame if one is held
+    scatter(lane);
+    machines_[lane]->romParser_->run(remaining_[lane]);
+    remaining_[lane] = 0;
+    gather(lane);
+  }
+}
+
+void LaneGroup::run_scalar(unsigned int lane) {
+  scatter(lane);
+  machines_[lane]->romParser_->run(1);
+  remaining_[lane]--;
+  stats_.scalar++;
+  gather(lane);
+  settle(lane);
+}
+
+bool LaneGroup::is_lane_wise(op::opcode_t opcode) {
+  switch (op::TABLE[opcode]) {
+    case op::Handler::jp_1nnn:
+    case op::Handler::se_3xkk:
+    case op::Handler::sne_4xkk:
+    case op::Handler::se_5xy0:
+    case op::Handler::ld_6xkk:
+    case op::Handler::add_7xkk:
+    case op::Handler::ld_8xy0:
+    case op::Handler::or_8xy1:
+    case op::Handler::and_8xy2:
+    case op::Handler::xor_8xy3:
+    case op::Handler::add_8xy4:
+    case op::Handler::sub_8xy5:
+    case op::Handler::shr_8xy6:
+    case op::Handler::subn_8xy7:
+    case op::Handler::shl_8xyE:
+    case op::Handler::sne_9xy0:
+    case op::Handler::ld_Annn:
+    case op::Handler::jp_Bnnn:
+    case op::Handler::add_Fx1E:
+    case op::Handler::ld_Fx29:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void LaneGroup::execute(op::opcode_t opcode, bytes_t mask) {
+  words_t wide_mask = (words_t) __builtin_convertvector((signed_bytes_t) mask, signed_words_t);
+  bytes_t & vx = v_[op::x(opcode)];
+  bytes_t & vy = v_[op::y(opcode)];
+  bytes_t & vf = v_[0xF];
+  uint8_t kk = op::kk(opcode);
+
+  assign(pc_, wide_mask, pc_ + 2);
+
+  // Same statements, in the same order, as the Instructions methods, VF being written before Vx.
+  switch (op::TABLE[opcode]) {
+    case op::Handler::jp_1nnn:
+      assign(pc_, wide_mask, words_t{} + op::nnn(opcode));
+      break;
+    case op::Handler::se_3xkk:
+      skip_next(mask & (bytes_t) (vx == kk));
+      break;
+    case op::Handler::sne_4xkk:
+      skip_next(mask & (bytes_t) (vx != kk));
+      break;
+    case op::Handler::se_5xy0:
+      skip_next(mask & (bytes_t) (vx == vy));
+      break;
+    case op::Handler::sne_9xy0:
+      skip_next(mask & (bytes_t) (vx != vy));
+      break;
+    case op::Handler::ld_6xkk:
+      vx = select(mask, bytes_t{} + kk, vx);
+      break;
+    case op::Handler::add_7xkk:
+      vx = select(mask, vx + kk, vx);
+      break;
+    case op::Handler::ld_8xy0:
+      vx = select(mask, vy, vx);
+      break;
+    case op::Handler::or_8xy1:
+      vx = select(mask, vx | vy, vx);
+      if (logic_resets_vf_) { vf = select(mask, bytes_t{}, vf); }
+      break;
+    case op::Handler::and_8xy2:
+      vx = select(mask, vx & vy, vx);
+      if (logic_resets_vf_) { vf = select(mask, bytes_t{}, vf); }
+      break;
+    case op::Handler::xor_8xy3:
+      vx = select(mask, vx ^ vy, vx);
+      if (logic_resets_vf_) { vf = select(mask, bytes_t{}, vf); }
+      break;
+    case op::Handler::add_8xy4:
+      vf = select(mask, (bytes_t) ((bytes_t) (vx + vy) < vx) & 1, vf);
+      vx = select(mask, vx + vy, vx);
+      break;
+    case op::Handler::sub_8xy5:
+      vf = select(mask, (bytes_t) (vx > vy) & 1, vf);
+      vx = select(mask, vx - vy, vx);
+      break;
+    case op::Handler::shr_8xy6:
+      if (shift_sets_vy_) { vx = select(mask, vy, vx); }
+      vf = select(mask, vx & 1, vf);
+      vx = select(mask, vx >> 1, vx);
+      break;
+    case op::Handler::subn_8xy7:
+      vf = select(mask, (bytes_t) (vy > vx) & 1, vf);
+      vx = select(mask, vy - vx, vx);
+      break;
+    case op::Handler::shl_8xyE:
+      if (shift_sets_vy_) { vx = select(mask, vy, vx); }
+      vf = select(mask, vx >> 7, vf);
+      vx = select(mask, vx << 1, vx);
+      break;
+    case op::Handler::ld_Annn:
+      assign(i_, wide_mask, words_t{} + op::nnn(opcode));
+      break;
+    case op::Handler::jp_Bnnn:
+      assign(pc_, wide_mask,
+             __builtin_convertvector(jump_uses_vx_ ? vx : v_[0], words_t) + op::nnn(opcode));
+      break;
+    case op::Handler::add_Fx1E: {
+      // I + Vx is not truncated in the comparison
+      words_t sum = i_ + __builtin_convertvector(vx, words_t);
+      signed_words_t carry = (sum > 0xFFF) | (sum < i_);
+      vf = select(mask, (bytes_t) __builtin_convertvector(carry, signed_bytes_t) & 1, vf);
+      assign(i_, wide_mask, i_ + __builtin_convertvector(vx, words_t));
+      break;
+    }
+    case op::Handler::ld_Fx29:
+      assign(i_, wide_mask, __builtin_convertvector(vx & 0xF, words_t) * 5);
+      break;
+    default:
+      break;
+  }
+}
+
+void LaneGroup::skip_next(bytes_t mask) {
+  for (unsigned int lane = 0; lane < machines_.size(); lane++) {
+    if (!mask[lane]) { continue; }
+    const mem::Memory & memory = *memories_[lane];
+    mem::address_t pc = pc_[lane];
+    bool long_load = static_cast<unsigned int>(pc) + 1 < mem::MEMORY_SIZE &&
+                     memory.peek(pc) == 0xF0 && memory.peek(pc + 1) == 0x00;
+    pc_[lane] += long_load ? 4 : 2;
+  }
+}
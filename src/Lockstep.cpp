@@ -0,0 +1,202 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Lockstep.h"
+
+#include <random>
+#include <sstream>
+
+namespace {
+  const uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+  const uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+  uint64_t digest(uint64_t hash, uint8_t byte) {
+    return (hash ^ byte) * FNV_PRIME;
+  }
+
+  template<typename T>
+  void compare(std::stringstream & out, const char * name, const T & a, const T & b) {
+    if (a != b) { out << name << ": " << +a << " != " << +b << "\n"; }
+  }
+
+  std::string join(const std::vector<uint16_t> & stack) {
+    std::stringstream out;
+    out << std::hex << "[";
+    for (size_t i = 0; i < stack.size(); i++) { out << (i ? " 0x" : "0x") << stack[i]; }
+    out << "]";
+    return out.str();
+  }
+}// namespace
+
+MachineState MachineState::capture(const Machine & machine) {
+  MachineState state{};
+  reg::RegisterManager & registers = *machine.registers_;
+  for (uint8_t v = 0; v < 0x10; v++) { state.v[v] = registers.v_[v].peek(); }
+  state.i = registers.i_.peek();
+  state.pc = registers.pc_.peek();
+  state.dt = registers.dt_.peek();
+  state.st = registers.st_.peek();
+  for (std::stack<uint16_t> stack = registers.stack_; !stack.empty(); stack.pop()) {
+    state.stack.insert(state.stack.begin(), stack.top());
+  }
+  state.rpl = registers.rpl_;
+  state.halted = registers.halted_;
+  state.exited = registers.exited_;
+  state.fault = registers.fault_;
+  state.faulted = registers.faulted_;
+
+  const Display & display = *machine.interface_->display_;
+  state.hires = display.is_hires();
+  state.planes = display.get_planes();
+
+  state.memory_digest = FNV_OFFSET;
+  for (unsigned int address = 0; address < mem::MEMORY_SIZE; address++) {
+    state.memory_digest = digest(state.memory_digest, machine.memory_->peek(address));
+  }
+  state.display_digest = FNV_OFFSET;
+  for (uint8_t plane = 0; plane < Display::PLANES; plane++) {
+    for (unsigned short int y = 0; y < Display::MAX_SIZE_Y; y++) {
+      Display::row_t row = display.get_row(y, plane);
+      for (int byte = 0; byte < 16; byte++) {
+        state.display_digest = digest(state.display_digest, row >> (byte * 8));
+      }
+    }
+  }
+  return state;
+}
+
+std::string MachineState::diff(const MachineState & other) const {
+  std::stringstream out;
+  out << std::hex << std::showbase;
+  for (uint8_t v = 0; v < 0x10; v++) {
+    std::string name = "v" + std::to_string(v);
+    compare(out, name.c_str(), this->v[v], other.v[v]);
+  }
+  compare(out, "i", i, other.i);
+  compare(out, "pc", pc, other.pc);
+  compare(out, "dt", dt, other.dt);
+  compare(out, "st", st, other.st);
+  if (stack != other.stack) {
+    out << "stack: " << join(stack) << " != " << join(other.stack) << "\n";
+  }
+  for (uint8_t r = 0; r < 0x10; r++) {
+    std::string name = "rpl" + std::to_string(r);
+    compare(out, name.c_str(), rpl[r], other.rpl[r]);
+  }
+  compare(out, "halted", halted, other.halted);
+  compare(out, "exited", exited, other.exited);
+  if (fault != other.fault) {
+    out << "fault: " << FAULT_NAMES[static_cast<size_t>(fault)]
+        << " != " << FAULT_NAMES[static_cast<size_t>(other.fault)] << "\n";
+  }
+  compare(out, "faulted", faulted, other.faulted);
+  compare(out, "hires", hires, other.hires);
+  compare(out, "planes", planes, other.planes);
+  compare(out, "memory digest", memory_digest, other.memory_digest);
+  compare(out, "display digest", display_digest, other.display_digest);
+  return out.str();
+}
+
+Lockstep::Lockstep(const std::shared_ptr<Configuration> & configuration)
+    : reference_(make_reference(configuration)), candidate_(configuration) {}
+
+std::shared_ptr<Configuration>
+Lockstep::make_reference(const std::shared_ptr<Configuration> & configuration) {
+  if (configuration->getSeed() == 0) {
+    std::random_device rd;
+    configuration->setSeed(std::max(1u, static_cast<unsigned int>(rd())));
+  }
+  std::shared_ptr<Configuration> reference = std::make_shared<Configuration>(*configuration);
+  reference->setFusion(false);
+  reference->setIdleSkip(false);
+  reference->setNativePath("");
+  return reference;
+}
+
+unsigned long Lockstep::run(unsigned long cycles, unsigned int interval) {
+  if (interval == 0) { throw std::runtime_error("Lockstep interval must be at least 1 cycle"); }
+  unsigned long elapsed = 0;
+
+  while (elapsed < cycles && report_.empty() && !reference_.registers_->exited_ &&
+         !reference_.registers_->faulted_) {
+    unsigned int budget = std::min<unsigned long>(interval, cycles - elapsed);
+    // For the report only, the fetch faulting when pc leaves the memory
+    mem::address_t pc = reference_.registers_->pc_.peek();
+    uint16_t opcode = 0x0000;
+    if (pc < mem::MEMORY_SIZE) { opcode = reference_.memory_->peek(pc) << 8; }
+    if (static_cast<unsigned int>(pc) + 1 < mem::MEMORY_SIZE) {
+      opcode += reference_.memory_->peek(pc + 1);
+    }
+
+    unsigned int ran = reference_.romParser_->run(budget);
+    unsigned int candidate_ran = candidate_.romParser_->run(budget);
+
+    std::string diff = MachineState::capture(reference_).diff(MachineState::capture(candidate_));
+    if (ran != candidate_ran) {
+      diff = "cycles run: " + std::to_string(ran) + " != " + std::to_string(candidate_ran) + "\n" +
+             diff;
+    }
+    if (!diff.empty()) {
+      char from[64];
+      snprintf(from, sizeof(from), "0x%03X %s", pc, op::disassemble(opcode).c_str());
+      report_ = "Diverged within cycles " + std::to_string(cycles_ + 1) + " to " +
+                std::to_string(cycles_ + budget) + ", from " + from + "\n" + diff;
+      locate_divergence();
+      break;
+    }
+    elapsed += budget;
+    cycles_ += budget;
+  }
+  return elapsed;
+}
+
+void Lockstep::locate_divergence() {
+  for (unsigned int address = 0; address < mem::MEMORY_SIZE; address++) {
+    uint8_t a = reference_.memory_->peek(address);
+    uint8_t b = candidate_.memory_->peek(address);
+    if (a != b) {
+      char line[64];
+      snprintf(line, sizeof(line), "memory[0x%03X]: 0x%02X != 0x%02X\n", address, a, b);
+      report_ += line;
+      break;
+    }
+  }
+
+  const Display & a = *reference_.interface_->display_;
+  const Display & b = *candidate_.interface_->display_;
+  for (uint8_t plane = 0; plane < Display::PLANES; plane++) {
+    for (unsigned short int y = 0; y < Display::MAX_SIZE_Y; y++) {
+      if (a.get_row(y, plane) != b.get_row(y, plane)) {
+        report_ += "display: row " + std::to_string(y) + " of plane " + std::to_string(plane) +
+                   " differs\n";
+        return;
+      }
+    }
+  }
+}
+
+void Lockstep::press(uint8_t key) {
+  reference_.interface_->keypad_->press(key);
+  candidate_.interface_->keypad_->press(key);
+}
+
+void Lockstep::release(uint8_t key) {
+  reference_.interface_->keypad_->release(key);
+  candidate_.interface_->keypad_->release(key);
+}
+
+bool Lockstep::has_diverged() const {
+  return !report_.empty();
+}
+
+const std::string & Lockstep::get_report() const {
+  return report_;
+}
+
+const Machine & Lockstep::get_reference() const {
+  return reference_;
+}
+
+const Machine & Lockstep::get_candidate() const {
+  return candidate_;
+}
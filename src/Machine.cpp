@@ -0,0 +1,58 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Machine.h"
+
+#include <algorithm>
+
+#include "Fingerprint.h"
+
+Machine::Machine(const std::shared_ptr<Configuration> & configuration, bool load_rom)
+    : Machine(configuration,
+              std::make_shared<reg::RegisterManager>(configuration->getFrequency()),
+              std::make_shared<Frontend>(), load_rom) {}
+
+Machine::Machine(const std::shared_ptr<Configuration> & configuration,
+                 const std::shared_ptr<reg::RegisterManager> & registers,
+                 const std::shared_ptr<Frontend> & interface, bool load_rom)
+    : configuration_(configuration), registers_(registers), interface_(interface) {
+  memory_ = std::make_shared<mem::Memory>();
+  instructions_ = std::make_shared<Instructions>(configuration, memory_, registers_, interface_);
+  romParser_ = std::make_shared<RomParser>(configuration, memory_, registers_, instructions_,
+                                           load_rom);
+  if (!configuration->getNativePath().empty()) {
+    romParser_->load_native(configuration->getNativePath());
+  }
+}
+
+Snapshot Machine::save() const {
+  return {memory_->get_image(), *registers_, *interface_->display_,
+          interface_->keypad_->get_mask(), instructions_->get_random()};
+}
+
+void Machine::restore(const Snapshot & snapshot) {
+  memory_->set_image(snapshot.memory);
+  *registers_ = snapshot.registers;
+  *interface_->display_ = snapshot.display;
+  interface_->keypad_->set_mask(snapshot.keys);
+  instructions_->set_random(snapshot.random);
+}
+
+Display Machine::run_ahead(unsigned int frames) {
+  Snapshot snapshot = save();
+  romParser_->set_speculative(true);
+  for (unsigned int frame = 0; frame < frames && !registers_->exited_ && !registers_->faulted_;
+       frame++) {
+    romParser_->run(std::max<unsigned short int>(registers_->cycles_to_next_tick(), 1));
+  }
+  romParser_->set_speculative(false);
+  Display display = *interface_->display_;
+  restore(snapshot);
+  return display;
+}
+
+uint64_t Machine::get_hash() const {
+  uint64_t hash = fingerprint::of(memory_->get_hash(), registers_->get_hash());
+  hash = fingerprint::of(hash, interface_->display_->get_hash());
+  return fingerprint::of(hash, interface_->keypad_->get_mask());
+}
@@ -1,32 +1,113 @@
 // (c) 2021 Maxandre Ogeret
 // Licensed under MIT License
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 
+#include "Fingerprint.h"
 #include "Memory.h"
 
 using namespace mem;
 
+namespace {
+  static_assert(MEMORY_SIZE % PAGE_SIZE == 0, "The memory is made of whole pages");
+  static_assert(Memory::FONT_.size() + Memory::BIG_FONT_.size() <= PAGE_SIZE,
+                "The fonts fit in the first page");
+
+  /**
+   * @returns The memory every Memory starts from: the fonts in the first page, the other pages
+   * all sharing a single zero page. It holds a reference to its pages, so they are never written.
+   */
+  const image_t & get_boot_image() {
+    static const image_t boot = []() {
+      std::shared_ptr<page_t> zero = std::make_shared<page_t>();
+      zero->bytes.fill(0x0);
+      zero->hash = Memory::hash_page(*zero);
+      image_t image;
+      image.fill(zero);
+
+      image[0] = std::make_shared<page_t>(*zero);
+      std::copy(Memory::FONT_.begin(), Memory::FONT_.end(), image[0]->bytes.begin());
+      std::copy(Memory::BIG_FONT_.begin(), Memory::BIG_FONT_.end(),
+                image[0]->bytes.begin() + Memory::FONT_.size());
+      image[0]->hash = Memory::hash_page(*image[0]);
+      return image;
+    }();
+    return boot;
+  }
+}// namespace
+
 Memory::Memory() {
-  memory_.fill(0x0);
-  init();
+  set_image(get_boot_image());
 }
 
 void Memory::poke(uint8_t value, address_t address) {
   validate_address(address);
   validate_value(value);
-  memory_[address] = value;
+  page_t & page = get_writable(address);
+  uint8_t & byte = page.bytes[address % PAGE_SIZE];
+
+  uint64_t page_hash = page.hash;
+  page.hash += fingerprint::of(address % PAGE_SIZE, value) -
+               fingerprint::of(address % PAGE_SIZE, byte);
+  hash_ += place(address / PAGE_SIZE, page.hash) - place(address / PAGE_SIZE, page_hash);
+  byte = value;
 }
 
 void Memory::poke(std::vector<uint8_t> values, address_t address) {
+  if (values.empty()) { return; }
+  // Checked as a whole so a write past the last address does not wrap around to 0x0.
+  validate_address(address + values.size() - 1);
   for (int i = 0; i < values.size(); i++) { poke(values[i], address + i); }
 }
 
-uint8_t Memory::peek(address_t address) {
+uint8_t Memory::peek(address_t address) const {
   validate_address(address);
-  return memory_[address];
+  return memory_[address / PAGE_SIZE]->bytes[address % PAGE_SIZE];
+}
+
+const image_t & Memory::get_image() const {
+  return memory_;
+}
+
+void Memory::set_image(const image_t & image) {
+  memory_ = image;
+  hash_ = 0;
+  for (unsigned int index = 0; index < PAGES; index++) {
+    hash_ += place(index, memory_[index]->hash);
+  }
+}
+
+unsigned int Memory::get_private_pages() const {
+  return std::count_if(memory_.begin(), memory_.end(), [](const std::shared_ptr<page_t> & page) {
+    return page.use_count() == 1;
+  });
+}
+
+uint64_t Memory::get_hash() const {
+  return hash_;
+}
+
+uint64_t Memory::hash_page(const page_t & page) {
+  uint64_t hash = 0;
+  for (unsigned int offset = 0; offset < PAGE_SIZE; offset++) {
+    hash += fingerprint::of(offset, page.bytes[offset]);
+  }
+  return hash;
+}
+
+page_t & Memory::get_writable(address_t address) {
+  std::shared_ptr<page_t> & page = memory_[address / PAGE_SIZE];
+  if (page.use_count() != 1) {
+    page = std::make_shared<page_t>(*page);
+  } else {
+    // A copy just released elsewhere: its reads of the page happen before this write
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return *page;
 }
 
-void Memory::init() {
-  poke(FONT_, 0x000);
+uint64_t Memory::place(unsigned int index, uint64_t page_hash) {
+  return fingerprint::of(fingerprint::MEMORY + index, page_hash);
 }
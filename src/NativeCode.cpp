@@ -0,0 +1,52 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "NativeCode.h"
+
+#include <dlfcn.h>
+
+NativeCode::NativeCode(const std::string & path, uint64_t rom_hash) {
+  handle_ = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (handle_ == nullptr) {
+    throw std::runtime_error("Unable to load native code: " + std::string(dlerror()));
+  }
+
+  try {
+    if (*static_cast<const unsigned int *>(find("chip8_aot_abi_version")) !=
+        CHIP8_AOT_ABI_VERSION) {
+      throw std::runtime_error("Native code was compiled for another interpreter version.");
+    }
+    if (*static_cast<const uint64_t *>(find("chip8_aot_rom_hash")) != rom_hash) {
+      throw std::runtime_error("Native code was compiled from another ROM.");
+    }
+    run_ = reinterpret_cast<chip8_aot_run_t>(find("chip8_aot_run"));
+    code_map_ = static_cast<const uint8_t *>(find("chip8_aot_code_map"));
+    code_map_size_ = *static_cast<const unsigned int *>(find("chip8_aot_code_map_size"));
+  } catch (const std::runtime_error &) {
+    dlclose(handle_);
+    throw;
+  }
+}
+
+NativeCode::~NativeCode() {
+  dlclose(handle_);
+}
+
+unsigned int NativeCode::run(chip8_aot_state & state, unsigned int max) const {
+  return run_(&state, max);
+}
+
+bool NativeCode::is_code(mem::address_t address, unsigned int size) const {
+  for (unsigned int byte = address; byte < address + size; byte++) {
+    if (byte / 8 < code_map_size_ && (code_map_[byte / 8] >> (byte % 8)) & 0x1) { return true; }
+  }
+  return false;
+}
+
+void * NativeCode::find(const char * name) const {
+  void * symbol = dlsym(handle_, name);
+  if (symbol == nullptr) {
+    throw std::runtime_error("Native code is missing " + std::string(name));
+  }
+  return symbol;
+}
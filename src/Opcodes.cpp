@@ -0,0 +1,76 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Opcodes.h"
+
+#include <cstdio>
+
+using namespace op;
+
+namespace {
+  /**
+   * Writes each instruction of SPEC over every opcode matching its pattern, enumerating only the
+   * operand bits so the table is built in about one step per opcode.
+   */
+  constexpr std::array<Handler, 0x10000> build_table() {
+    std::array<Handler, 0x10000> table{};
+    for (size_t i = 1; i < SPEC.size(); i++) {
+      opcode_t operands = ~SPEC[i].mask;
+      for (opcode_t bits = operands;; bits = (bits - 1) & operands) {
+        table[SPEC[i].pattern | bits] = SPEC[i].handler;
+        if (bits == 0) { break; }
+      }
+    }
+    return table;
+  }
+
+  constexpr bool is_indexed_by_handler() {
+    for (size_t i = 0; i < SPEC.size(); i++) {
+      if (static_cast<size_t>(SPEC[i].handler) != i) { return false; }
+    }
+    return true;
+  }
+
+  static_assert(is_indexed_by_handler(), "SPEC must be in the Handler order");
+}// namespace
+
+constexpr std::array<Handler, 0x10000> op::TABLE = build_table();
+
+static_assert(TABLE[0x00E0] == Handler::cls_00E0);
+static_assert(TABLE[0x0123] == Handler::sys_0nnn);
+static_assert(TABLE[0xD125] == Handler::drw_Dxyn);
+static_assert(TABLE[0x8128] == Handler::unknown);
+static_assert(TABLE[0xF100] == Handler::unknown);
+
+std::string op::disassemble(opcode_t opcode) {
+  const Spec & spec = get_spec(opcode);
+  char buffer[32];
+
+  switch (spec.operands) {
+    case Operands::none:
+      snprintf(buffer, sizeof(buffer), "%s", spec.mnemonic);
+      break;
+    case Operands::nnn:
+      snprintf(buffer, sizeof(buffer), spec.mnemonic, nnn(opcode));
+      break;
+    case Operands::xkk:
+      snprintf(buffer, sizeof(buffer), spec.mnemonic, x(opcode), kk(opcode));
+      break;
+    case Operands::xy:
+      snprintf(buffer, sizeof(buffer), spec.mnemonic, x(opcode), y(opcode));
+      break;
+    case Operands::xyn:
+      snprintf(buffer, sizeof(buffer), spec.mnemonic, x(opcode), y(opcode), n(opcode));
+      break;
+    case Operands::x:
+      snprintf(buffer, sizeof(buffer), spec.mnemonic, x(opcode));
+      break;
+    case Operands::n:
+      snprintf(buffer, sizeof(buffer), spec.mnemonic, n(opcode));
+      break;
+    case Operands::opcode:
+      snprintf(buffer, sizeof(buffer), spec.mnemonic, opcode);
+      break;
+  }
+  return buffer;
+}
@@ -0,0 +1,107 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "QuirkDatabase.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "Aot.h"
+
+namespace {
+  const std::string SWITCHES = "1234";
+}// namespace
+
+std::shared_ptr<Configuration> quirk::make_configuration(const std::string & rom_path,
+                                                         int frequency, unsigned int quirks) {
+  return std::make_shared<Configuration>(rom_path, frequency, quirks & SHIFT_SETS_VY,
+                                         quirks & JUMP_USES_VX, quirks & LOAD_STORE_INCREMENTS_I,
+                                         quirks & LOGIC_RESETS_VF);
+}
+
+unsigned int quirk::get_quirks(const Configuration & configuration) {
+  return (configuration.isC8Xy68XyESetsVy() ? SHIFT_SETS_VY : 0) |
+         (configuration.isCBnnnBecomesBxnn() ? JUMP_USES_VX : 0) |
+         (configuration.isCFx55Fx65IncrementsI() ? LOAD_STORE_INCREMENTS_I : 0) |
+         (configuration.isC8Xy18Xy28Xy3ResetVf() ? LOGIC_RESETS_VF : 0);
+}
+
+std::string quirk::format(unsigned int quirks) {
+  std::string text = "----";
+  for (size_t bit = 0; bit < SWITCHES.size(); bit++) {
+    if (quirks & (0x1 << bit)) { text[bit] = SWITCHES[bit]; }
+  }
+  return text;
+}
+
+unsigned int quirk::parse(const std::string & text) {
+  if (text.size() != SWITCHES.size()) { throw std::runtime_error("Invalid quirks: " + text); }
+  unsigned int quirks = 0;
+  for (size_t bit = 0; bit < SWITCHES.size(); bit++) {
+    if (text[bit] == SWITCHES[bit]) {
+      quirks |= 0x1 << bit;
+    } else if (text[bit] != '-') {
+      throw std::runtime_error("Invalid quirks: " + text);
+    }
+  }
+  return quirks;
+}
+
+QuirkDatabase::QuirkDatabase(const std::string & path) : path_(path) {
+  std::ifstream source(path);
+  std::string line;
+  for (unsigned int number = 1; std::getline(source, line); number++) {
+    if (line.empty() || line[0] == '#') { continue; }
+
+    std::istringstream fields(line);
+    std::string hash, quirks, name;
+    fields >> hash >> quirks;
+    std::getline(fields >> std::ws, name);
+    size_t parsed = 0;
+    try {
+      uint64_t rom_hash = std::stoull(hash, &parsed, 16);
+      if (parsed != hash.size()) { throw std::invalid_argument(hash); }
+      entries_[rom_hash] = {quirk::parse(quirks), name};
+    } catch (const std::exception &) {
+      throw std::runtime_error(path + ":" + std::to_string(number) + ": malformed line.");
+    }
+  }
+}
+
+std::optional<unsigned int> QuirkDatabase::find(uint64_t rom_hash) const {
+  auto entry = entries_.find(rom_hash);
+  if (entry == entries_.end()) { return std::nullopt; }
+  return entry->second.quirks;
+}
+
+std::optional<unsigned int> QuirkDatabase::find_rom(const std::string & rom_path) const {
+  std::ifstream source(rom_path, std::ios_base::binary);
+  if (!source) { return std::nullopt; }
+  std::vector<uint8_t> rom((std::istreambuf_iterator<char>(source)),
+                           std::istreambuf_iterator<char>());
+  return find(chip8_aot_hash(rom.data(), rom.size()));
+}
+
+void QuirkDatabase::set(uint64_t rom_hash, unsigned int quirks, const std::string & name) {
+  entries_[rom_hash] = {quirks, name};
+}
+
+void QuirkDatabase::save() const {
+  std::ofstream output(path_);
+  output << "# ROM hash, quirks -1 to -4, ROM name. Written by CHIP8_QUIRKS.\n";
+  for (const auto & entry : entries_) {
+    output << std::hex << std::uppercase << std::setw(16) << std::setfill('0') << entry.first
+           << " " << quirk::format(entry.second.quirks);
+    if (!entry.second.name.empty()) { output << " " << entry.second.name; }
+    output << "\n";
+  }
+  if (!output) { throw std::runtime_error("Unable to write " + path_ + "."); }
+}
+
+size_t QuirkDatabase::size() const {
+  return entries_.size();
+}
@@ -0,0 +1,161 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "QuirkSweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+#include "Aot.h"
+#include "Lockstep.h"
+#include "Machine.h"
+
+namespace {
+  const mem::address_t ROM_START = 0x200;
+  // A random key is held for the first PRESS_FRAMES of every PRESS_PERIOD frames
+  const unsigned long PRESS_PERIOD = 30;
+  const unsigned long PRESS_FRAMES = 5;
+
+  // Fewest quirks first, then lowest flags
+  bool is_simpler(unsigned int a, unsigned int b) {
+    size_t a_count = std::bitset<4>(a).count();
+    size_t b_count = std::bitset<4>(b).count();
+    return a_count != b_count ? a_count < b_count : a < b;
+  }
+}// namespace
+
+QuirkSweep::QuirkSweep(const std::vector<uint8_t> & rom, int frequency, unsigned int seed)
+    : rom_(rom), frequency_(frequency), seed_(seed), results_(quirk::COMBINATIONS),
+      frames_(quirk::COMBINATIONS) {
+  if (rom.size() > mem::MEMORY_SIZE - ROM_START) {
+    throw std::runtime_error("The ROM does not fit in memory.");
+  }
+}
+
+void QuirkSweep::run(unsigned long cycles, unsigned int threads) {
+  std::atomic<unsigned int> next{0};
+  auto work = [&]() {
+    for (unsigned int quirks = next++; quirks < quirk::COMBINATIONS; quirks = next++) {
+      run_combination(quirks, cycles);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 1; t < std::min(std::max(threads, 1U), quirk::COMBINATIONS); t++) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread & worker : workers) { worker.join(); }
+
+  compare();
+}
+
+const std::vector<QuirkResult> & QuirkSweep::get_results() const {
+  return results_;
+}
+
+std::optional<unsigned int> QuirkSweep::get_recommended() const {
+  return recommended_;
+}
+
+bool QuirkSweep::is_ambiguous() const {
+  return ambiguous_;
+}
+
+uint64_t QuirkSweep::get_rom_hash() const {
+  return chip8_aot_hash(rom_.data(), rom_.size());
+}
+
+void QuirkSweep::run_combination(unsigned int quirks, unsigned long cycles) {
+  std::shared_ptr<Configuration> configuration = quirk::make_configuration("", frequency_, quirks);
+  configuration->setSeed(seed_);
+  Machine machine(configuration, false);
+  machine.romParser_->load(rom_);
+  const reg::RegisterManager & registers = *machine.registers_;
+
+  QuirkResult & result = results_[quirks];
+  result = {quirks, Outcome::completed, 0, Fault::none, 0, false, 0};
+  std::vector<uint64_t> & frames = frames_[quirks];
+  frames.clear();
+
+  MachineState previous = MachineState::capture(machine);
+  unsigned int still = 0;
+  while (result.cycles < cycles) {
+    machine.interface_->keypad_->set_mask(get_keys(frames.size()));
+    unsigned long frame = std::max<unsigned int>(registers.cycles_to_next_tick(), 1);
+    frame = std::min(frame, cycles - result.cycles);
+    machine.romParser_->run(frame);
+    result.cycles += frame;
+
+    MachineState state = MachineState::capture(machine);
+    frames.push_back(state.display_digest);
+    if (registers.faulted_) {
+      result.outcome = Outcome::faulted;
+      result.fault = registers.fault_;
+      break;
+    }
+    if (registers.exited_) {
+      result.outcome = Outcome::exited;
+      break;
+    }
+    // Waiting for a key is not stalling, the program goes on once one is pressed
+    still = !registers.halted_ && state.diff(previous).empty() ? still + 1 : 0;
+    if (still == STALL_FRAMES) {
+      result.outcome = Outcome::stalled;
+      break;
+    }
+    previous = state;
+  }
+  result.display_digest = frames.empty() ? previous.display_digest : frames.back();
+}
+
+uint16_t QuirkSweep::get_keys(unsigned long frame) const {
+  if (frame % PRESS_PERIOD >= PRESS_FRAMES) { return 0x0; }
+  uint32_t hash = static_cast<uint32_t>(frame / PRESS_PERIOD) * 2654435761U + seed_;
+  return 0x1 << ((hash >> 16) & 0xF);
+}
+
+void QuirkSweep::compare() {
+  // Combinations ending on each frame, simplest first
+  std::map<uint64_t, std::vector<unsigned int>> endings;
+  for (unsigned int quirks = 0; quirks < quirk::COMBINATIONS; quirks++) {
+    const QuirkResult & result = results_[quirks];
+    if (result.outcome == Outcome::faulted) { continue; }
+    endings[result.display_digest].push_back(quirks);
+  }
+  for (auto & ending : endings) {
+    std::sort(ending.second.begin(), ending.second.end(), is_simpler);
+  }
+
+  const std::vector<unsigned int> * majority = nullptr;
+  ambiguous_ = false;
+  for (const auto & ending : endings) {
+    const std::vector<unsigned int> & group = ending.second;
+    if (majority && group.size() == majority->size()) { ambiguous_ = true; }
+    if (!majority || group.size() > majority->size()) {
+      majority = &group;
+      ambiguous_ = false;
+    }
+  }
+  recommended_.reset();
+  // Without a majority no combination is expected, none diverges
+  if (!majority || ambiguous_) { return; }
+  recommended_ = (*majority)[0];
+
+  const std::vector<uint64_t> & expected = frames_[*recommended_];
+  for (const auto & ending : endings) {
+    for (unsigned int quirks : ending.second) {
+      QuirkResult & result = results_[quirks];
+      result.diverged = result.display_digest != results_[*recommended_].display_digest;
+      if (!result.diverged) { continue; }
+      const std::vector<uint64_t> & frames = frames_[quirks];
+      auto end = frames.begin() + std::min(frames.size(), expected.size());
+      result.divergence_frame = std::mismatch(frames.begin(), end, expected.begin()).first -
+                                frames.begin();
+    }
+  }
+}
@@ -0,0 +1,213 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Recompiler.h"
+
+#include <cstdio>
+
+namespace {
+  const mem::address_t ROM_START = 0x200;
+
+  std::string format(const char * pattern, unsigned int a, unsigned int b = 0,
+                     unsigned int c = 0) {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), pattern, a, b, c);
+    return buffer;
+  }
+}// namespace
+
+Recompiler::Recompiler(const std::vector<uint8_t> & rom) : rom_(rom) {
+  std::vector<mem::address_t> pending = {ROM_START};
+
+  while (!pending.empty()) {
+    mem::address_t address = pending.back();
+    pending.pop_back();
+    if (!is_in_rom(address) || instructions_.count(address)) { continue; }
+
+    op::opcode_t opcode = opcode_at(address);
+    instructions_[address] = opcode;
+    for (mem::address_t next : get_successors(address, opcode)) { pending.push_back(next); }
+  }
+}
+
+const std::map<mem::address_t, op::opcode_t> & Recompiler::get_instructions() const {
+  return instructions_;
+}
+
+std::vector<mem::address_t> Recompiler::get_successors(mem::address_t address,
+                                                       op::opcode_t opcode) const {
+  mem::address_t next = address + instruction_size(address);
+
+  switch (op::TABLE[opcode]) {
+    case op::Handler::unknown:
+    case op::Handler::ret_00EE:
+    case op::Handler::exit_00FD:
+    case op::Handler::jp_Bnnn:
+      return {};
+    case op::Handler::jp_1nnn:
+      return {op::nnn(opcode)};
+    case op::Handler::call_2nnn:
+      return {op::nnn(opcode), next};
+    case op::Handler::se_3xkk:
+    case op::Handler::sne_4xkk:
+    case op::Handler::se_5xy0:
+    case op::Handler::sne_9xy0:
+    case op::Handler::skp_Ex9E:
+    case op::Handler::sknp_ExA1:
+      return {next, static_cast<mem::address_t>(next + instruction_size(next))};
+    default:
+      return {next};
+  }
+}
+
+void Recompiler::emit(std::ostream & out, const std::string & name) const {
+  std::vector<uint8_t> code_map((mem::MEMORY_SIZE + 7) / 8, 0x0);
+  std::vector<std::string> bodies;
+
+  for (const auto & instruction : instructions_) {
+    mem::address_t address = instruction.first;
+    mem::address_t next = address + instruction_size(address);
+    for (mem::address_t byte = address; byte < next; byte++) {
+      code_map[byte / 8] |= 0x1 << (byte % 8);
+    }
+
+    std::string body = translate(address, instruction.second, next);
+    if (body.empty()) {
+      // pc as fetched, past the opcode but not the operand of an F000
+      body = format("        s->pc = 0x%03X;\n"
+                    "        if (s->exec(s, 0x%04X)) { return n; }\n",
+                    address + 2, instruction.second) +
+             format("        if (s->pc != 0x%03X) { continue; }\n", next);
+    }
+
+    // Falls through to the next instruction, unless it is not the next case.
+    auto following = instructions_.upper_bound(address);
+    bool jumps = op::TABLE[instruction.second] == op::Handler::jp_1nnn;
+    if (!jumps && (following == instructions_.end() || following->first != next)) {
+      body += "        " + jump(next) + "\n";
+    }
+    bodies.push_back(body);
+  }
+
+  std::set<mem::address_t> labels;
+  for (const std::string & body : bodies) {
+    for (size_t at = body.find("goto L"); at != std::string::npos;
+         at = body.find("goto L", at + 1)) {
+      labels.insert(std::stoi(body.substr(at + 6, 4), nullptr, 16));
+    }
+  }
+
+  char hash[32];
+  snprintf(hash, sizeof(hash), "0x%016llXULL",
+           static_cast<unsigned long long>(chip8_aot_hash(rom_.data(), rom_.size())));
+
+  out << "// Generated by CHIP8_AOT from " << name << ", do not edit.\n"
+      << "// " << instructions_.size() << " instructions reachable from 0x200.\n\n"
+      << "#include \"Aot.h\"\n\n"
+      << "extern \"C\" {\n"
+      << "const unsigned int chip8_aot_abi_version = CHIP8_AOT_ABI_VERSION;\n"
+      << "const uint64_t chip8_aot_rom_hash = " << hash << ";\n";
+
+  out << "const unsigned int chip8_aot_code_map_size = " << code_map.size() << ";\n"
+      << "const uint8_t chip8_aot_code_map[] = {";
+  for (size_t i = 0; i < code_map.size(); i++) {
+    out << (i % 16 == 0 ? "\n        " : " ") << format("0x%02X,", code_map[i]);
+  }
+  out << "};\n\n";
+
+  out << "unsigned int chip8_aot_run(struct chip8_aot_state * s, unsigned int max) {\n"
+      << "  unsigned int n = 0;\n"
+      << "  for (;;) {\n"
+      << "    switch (s->pc) {\n";
+  size_t index = 0;
+  for (const auto & instruction : instructions_) {
+    mem::address_t address = instruction.first;
+    out << format("      case 0x%03X:", address)
+        << (labels.count(address) ? format(" L%04X:", address) : "") << " // "
+        << op::disassemble(instruction.second) << "\n"
+        << format("        if (n == max) {\n"
+                  "          s->pc = 0x%03X;\n"
+                  "          return n;\n"
+                  "        }\n",
+                  address)
+        << "        n++;\n"
+        << bodies[index++];
+  }
+  out << "      default:\n"
+      << "        return n;\n"
+      << "    }\n"
+      << "  }\n"
+      << "}\n"
+      << "}\n";
+}
+
+bool Recompiler::is_in_rom(mem::address_t address) const {
+  return address >= ROM_START && static_cast<size_t>(address) + 1 < ROM_START + rom_.size();
+}
+
+op::opcode_t Recompiler::opcode_at(mem::address_t address) const {
+  return (rom_[address - ROM_START] << 8) + rom_[address - ROM_START + 1];
+}
+
+uint8_t Recompiler::instruction_size(mem::address_t address) const {
+  bool long_load = is_in_rom(address) && opcode_at(address) == 0xF000;
+  return long_load ? 4 : 2;
+}
+
+std::string Recompiler::translate(mem::address_t address, op::opcode_t opcode,
+                                  mem::address_t next) const {
+  uint8_t x = op::x(opcode);
+  uint8_t y = op::y(opcode);
+  std::string skip = jump(next + instruction_size(next));
+
+  // Same statements, in the same order, as the Instructions methods.
+  switch (op::TABLE[opcode]) {
+    case op::Handler::jp_1nnn:
+      return "        " + jump(op::nnn(opcode)) + "\n";
+    case op::Handler::se_3xkk:
+      return format("        if (s->v[%u] == 0x%02X) { ", x, op::kk(opcode)) + skip + " }\n";
+    case op::Handler::sne_4xkk:
+      return format("        if (s->v[%u] != 0x%02X) { ", x, op::kk(opcode)) + skip + " }\n";
+    case op::Handler::se_5xy0:
+      return format("        if (s->v[%u] == s->v[%u]) { ", x, y) + skip + " }\n";
+    case op::Handler::sne_9xy0:
+      return format("        if (s->v[%u] != s->v[%u]) { ", x, y) + skip + " }\n";
+    case op::Handler::ld_6xkk:
+      return format("        s->v[%u] = 0x%02X;\n", x, op::kk(opcode));
+    case op::Handler::add_7xkk:
+      return format("        s->v[%u] += 0x%02X;\n", x, op::kk(opcode));
+    case op::Handler::ld_8xy0:
+      return format("        s->v[%u] = s->v[%u];\n", x, y);
+    case op::Handler::add_8xy4:
+      return format("        s->v[15] = s->v[%u] + s->v[%u] > 0xFF;\n", x, y) +
+             format("        s->v[%u] = s->v[%u] + s->v[%u];\n", x, x, y);
+    case op::Handler::sub_8xy5:
+      return format("        s->v[15] = s->v[%u] > s->v[%u];\n", x, y) +
+             format("        s->v[%u] = s->v[%u] - s->v[%u];\n", x, x, y);
+    case op::Handler::subn_8xy7:
+      return format("        s->v[15] = s->v[%u] > s->v[%u];\n", y, x) +
+             format("        s->v[%u] = s->v[%u] - s->v[%u];\n", x, y, x);
+    case op::Handler::ld_Annn:
+      return format("        s->i = 0x%03X;\n", op::nnn(opcode));
+    case op::Handler::ld_F000:
+      if (!is_in_rom(address + 2)) { return ""; }
+      return format("        s->i = 0x%04X;\n", opcode_at(address + 2));
+    case op::Handler::ld_Fx07:
+      return format("        s->v[%u] = s->dt;\n", x);
+    case op::Handler::ld_Fx15:
+      return format("        s->dt = s->v[%u];\n", x);
+    case op::Handler::ld_Fx29:
+      return format("        s->i = (s->v[%u] & 0xF) * 5;\n", x);
+    default:
+      return "";
+  }
+}
+
+std::string Recompiler::jump(mem::address_t target) const {
+  if (instructions_.count(target)) { return format("goto L%04X;", target); }
+  return format("{\n"
+                "          s->pc = 0x%03X;\n"
+                "          return n;\n"
+                "        }",
+                target);
+}
@@ -3,13 +3,30 @@
 
 #include "register/RegisterManager.h"
 
+#include "Fingerprint.h"
+
 using namespace reg;
 
+namespace {
+  // Reads the container of a std::stack, bottom first, without copying it
+  struct StackView : std::stack<uint16_t> {
+    static const container_type & get(const std::stack<uint16_t> & stack) {
+      return stack.*&StackView::c;
+    }
+  };
+}// namespace
+
 RegisterManager::RegisterManager(const unsigned short int frequency) {
   pc_.poke(0x200);
   decrement_interval_ = frequency / 60;
 }
 
+void RegisterManager::raise(Fault fault) {
+  fault_ = fault;
+  faults_++;
+  faulted_ = true;
+}
+
 void RegisterManager::trigger_timers() {
   counter_++;
   if (counter_ == decrement_interval_) {
@@ -20,3 +37,43 @@ void RegisterManager::trigger_timers() {
     if (st_.peek() > 0) { st_.decrement(1); }
   }
 }
+
+unsigned short int RegisterManager::cycles_to_next_tick() const {
+  if (decrement_interval_ == 0) { return 0; }
+  return decrement_interval_ - counter_;
+}
+
+void RegisterManager::skip_cycles(unsigned short int cycles) {
+  if (cycles == 0) { return; }
+  if (cycles >= cycles_to_next_tick()) {
+    throw std::runtime_error("Skipping cycles would miss a timer tick.");
+  }
+  counter_ += cycles;
+}
+
+void RegisterManager::elapse(unsigned int cycles) {
+  if (decrement_interval_ == 0) { return; }
+
+  unsigned int ticks = (counter_ + cycles) / decrement_interval_;
+  counter_ = (counter_ + cycles) % decrement_interval_;
+
+  dt_.poke(dt_.peek() > ticks ? dt_.peek() - ticks : 0);
+  st_.poke(st_.peek() > ticks ? st_.peek() - ticks : 0);
+}
+
+uint64_t RegisterManager::get_hash() const {
+  uint64_t hash = fingerprint::REGISTERS;
+  for (const Register<uint8_t> & v : v_) { hash = fingerprint::of(hash, v.peek()); }
+  hash = fingerprint::of(hash, i_.peek());
+  hash = fingerprint::of(hash, (dt_.peek() << 8) | st_.peek());
+  hash = fingerprint::of(hash, pc_.peek());
+  for (uint16_t address : StackView::get(stack_)) { hash = fingerprint::of(hash, address); }
+  hash = fingerprint::of(hash, stack_.size());
+  hash = fingerprint::of(hash, (halted_ << 8) | key_register_);
+  hash = fingerprint::of(hash, (exited_ << 1) | faulted_);
+  hash = fingerprint::of(hash, (static_cast<uint64_t>(fault_) << 16) | fault_address_);
+  for (uint8_t flag : rpl_) { hash = fingerprint::of(hash, flag); }
+  for (uint8_t sample : audio_pattern_) { hash = fingerprint::of(hash, sample); }
+  hash = fingerprint::of(hash, (audio_pattern_loaded_ << 8) | pitch_);
+  return fingerprint::of(hash, counter_);
+}
@@ -6,9 +6,10 @@
 RomParser::RomParser(std::shared_ptr<Configuration> configuration,
                      std::shared_ptr<mem::Memory> memory,
                      std::shared_ptr<reg::RegisterManager> registerManager,
-                     std::shared_ptr<Instructions> instructions)
+                     std::shared_ptr<Instructions> instructions, bool load_rom)
     : configuration_(configuration), memory_(memory), registers_(registerManager),
       instructions_(instructions) {
+  if (!load_rom) { return; }
   std::cout << "Loading ROM: " << configuration_->getRomPath() << "\n";
 
   source_ = std::ifstream(configuration_->getRomPath(), std::ios_base::binary);
@@ -18,158 +19,208 @@ RomParser::RomParser(std::shared_ptr<Configuration> configuration,
   contents_ = std::vector<uint8_t>((std::istreambuf_iterator<char>(source_)),
                                    std::istreambuf_iterator<char>());
 
-  memory_->poke(contents_, 0x200);
+  load(contents_);
   contents_.clear();
   source_.close();
 }
 
-void RomParser::step() {
+void RomParser::load(const std::vector<uint8_t> & rom) {
+  memory_->poke(rom, 0x200);
+  rom_hash_ = chip8_aot_hash(rom.data(), rom.size());
+}
+
+void RomParser::share(const RomParser & loaded) {
+  memory_->set_image(loaded.memory_->get_image());
+  rom_hash_ = loaded.rom_hash_;
+}
+
+Fault RomParser::step() {
+  opcode_address_ = registers_->pc_.peek();
+  if (static_cast<unsigned int>(opcode_address_) + 1 >= mem::MEMORY_SIZE) {
+    registers_->raise(Fault::address_out_of_range);
+    registers_->fault_address_ = opcode_address_;
+    return Fault::address_out_of_range;
+  }
   opcode_ = (memory_->peek(registers_->pc_.peek()) << 8) +
             (memory_->peek(registers_->pc_.peek() + 1));
   registers_->pc_.increment(2);
+  return Fault::none;
 }
 
-void RomParser::decode() {
-  switch (get_from_opcode(opcode_, 0xF000)) {
-    case 0x0:
-      switch (get_from_opcode(opcode_, 0x000F)) {
-        case 0x0:
-          instructions_->cls_00E0();
-          return;
-        case 0xE:
-          instructions_->ret_00EE();
-          return;
-        default:
-          instructions_->sys_0nnn(get_from_opcode(opcode_, 0x0FFF));
-          return;
-      }
+Fault RomParser::decode() {
+  unsigned long faults = registers_->faults_;
+  switch (op::TABLE[opcode_]) {
+    case op::Handler::sys_0nnn:
+      instructions_->sys_0nnn(op::nnn(opcode_));
       break;
-    case 0x1:
-      instructions_->jp_1nnn(get_from_opcode(opcode_, 0x0FFF));
-      return;
-    case 0x2:
-      instructions_->call_2nnn(get_from_opcode(opcode_, 0x0FFF));
-      return;
-    case 0x3:
-      instructions_->se_3xkk(get_from_opcode(opcode_, 0x0F00), get_from_opcode(opcode_, 0x00FF));
-      return;
-    case 0x4:
-      instructions_->sne_4xkk(get_from_opcode(opcode_, 0x0F00), get_from_opcode(opcode_, 0x00FF));
-      return;
-    case 0x5:
-      instructions_->se_5xy0(get_from_opcode(opcode_, 0x0F00), get_from_opcode(opcode_, 0x00F0));
-      return;
-    case 0x6:
-      instructions_->ld_6xkk(get_from_opcode(opcode_, 0x0F00), get_from_opcode(opcode_, 0x00FF));
-      return;
-    case 0x7:
-      instructions_->add_7xkk(get_from_opcode(opcode_, 0x0F00), get_from_opcode(opcode_, 0x00FF));
-      return;
-    case 0x8:
-      switch (get_from_opcode(opcode_, 0x000F)) {
-        case 0x0:
-          instructions_->ld_8xy0(get_from_opcode(opcode_, 0x0F00),
-                                 get_from_opcode(opcode_, 0x00F0));
-          return;
-        case 0x1:
-          instructions_->or_8xy1(get_from_opcode(opcode_, 0x0F00),
-                                 get_from_opcode(opcode_, 0x00F0));
-          return;
-        case 0x2:
-          instructions_->and_8xy2(get_from_opcode(opcode_, 0x0F00),
-                                  get_from_opcode(opcode_, 0x00F0));
-          return;
-        case 0x3:
-          instructions_->xor_8xy3(get_from_opcode(opcode_, 0x0F00),
-                                  get_from_opcode(opcode_, 0x00F0));
-          return;
-        case 0x4:
-          instructions_->add_8xy4(get_from_opcode(opcode_, 0x0F00),
-                                  get_from_opcode(opcode_, 0x00F0));
-          return;
-        case 0x5:
-          instructions_->sub_8xy5(get_from_opcode(opcode_, 0x0F00),
-                                  get_from_opcode(opcode_, 0x00F0));
-          return;
-        case 0x6:
-          instructions_->shr_8xy6(get_from_opcode(opcode_, 0x0F00),
-                                  get_from_opcode(opcode_, 0x00F0));
-          return;
-        case 0x7:
-          instructions_->subn_8xy7(get_from_opcode(opcode_, 0x0F00),
-                                   get_from_opcode(opcode_, 0x00F0));
-          return;
-        case 0xE:
-          instructions_->shl_8xyE(get_from_opcode(opcode_, 0x0F00),
-                                  get_from_opcode(opcode_, 0x00F0));
-          return;
-      }
+    case op::Handler::cls_00E0:
+      instructions_->cls_00E0();
+      break;
+    case op::Handler::ret_00EE:
+      instructions_->ret_00EE();
+      break;
+    case op::Handler::scd_00Cn:
+      instructions_->scd_00Cn(op::n(opcode_));
+      break;
+    case op::Handler::scu_00Dn:
+      instructions_->scu_00Dn(op::n(opcode_));
+      break;
+    case op::Handler::scr_00FB:
+      instructions_->scr_00FB();
+      break;
+    case op::Handler::scl_00FC:
+      instructions_->scl_00FC();
+      break;
+    case op::Handler::exit_00FD:
+      instructions_->exit_00FD();
+      break;
+    case op::Handler::low_00FE:
+      instructions_->low_00FE();
+      break;
+    case op::Handler::high_00FF:
+      instructions_->high_00FF();
+      break;
+    case op::Handler::jp_1nnn:
+      instructions_->jp_1nnn(op::nnn(opcode_));
+      break;
+    case op::Handler::call_2nnn:
+      instructions_->call_2nnn(op::nnn(opcode_));
+      break;
+    case op::Handler::se_3xkk:
+      instructions_->se_3xkk(op::x(opcode_), op::kk(opcode_));
+      break;
+    case op::Handler::sne_4xkk:
+      instructions_->sne_4xkk(op::x(opcode_), op::kk(opcode_));
+      break;
+    case op::Handler::se_5xy0:
+      instructions_->se_5xy0(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::ld_5xy2:
+      instructions_->ld_5xy2(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::ld_5xy3:
+      instructions_->ld_5xy3(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::ld_6xkk:
+      instructions_->ld_6xkk(op::x(opcode_), op::kk(opcode_));
+      break;
+    case op::Handler::add_7xkk:
+      instructions_->add_7xkk(op::x(opcode_), op::kk(opcode_));
+      break;
+    case op::Handler::ld_8xy0:
+      instructions_->ld_8xy0(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::or_8xy1:
+      instructions_->or_8xy1(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::and_8xy2:
+      instructions_->and_8xy2(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::xor_8xy3:
+      instructions_->xor_8xy3(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::add_8xy4:
+      instructions_->add_8xy4(op::x(opcode_), op::y(opcode_));
       break;
-    case 0x9:
-      instructions_->sne_9xy0(get_from_opcode(opcode_, 0x0F00), get_from_opcode(opcode_, 0x00F0));
-      return;
-    case 0xA:
-      instructions_->ld_Annn(get_from_opcode(opcode_, 0x0FFF));
-      return;
-    case 0xB:
+    case op::Handler::sub_8xy5:
+      instructions_->sub_8xy5(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::shr_8xy6:
+      instructions_->shr_8xy6(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::subn_8xy7:
+      instructions_->subn_8xy7(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::shl_8xyE:
+      instructions_->shl_8xyE(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::sne_9xy0:
+      instructions_->sne_9xy0(op::x(opcode_), op::y(opcode_));
+      break;
+    case op::Handler::ld_Annn:
+      instructions_->ld_Annn(op::nnn(opcode_));
+      break;
+    case op::Handler::jp_Bnnn:
       if (configuration_->isCBnnnBecomesBxnn()) {
-        instructions_->jp_Bxnn(get_from_opcode(opcode_, 0x0F00), get_from_opcode(opcode_, 0x0FFF));
+        instructions_->jp_Bxnn(op::x(opcode_), op::nnn(opcode_));
       } else {
-        instructions_->jp_Bnnn(get_from_opcode(opcode_, 0x0FFF));
-      }
-      return;
-    case 0xC:
-      instructions_->rnd_Cxkk(get_from_opcode(opcode_, 0x0F00), get_from_opcode(opcode_, 0x00FF));
-      return;
-    case 0xD:
-      instructions_->drw_Dxyn(get_from_opcode(opcode_, 0x0F00), get_from_opcode(opcode_, 0x00F0),
-                              get_from_opcode(opcode_, 0x000F));
-      return;
-    case 0xE:
-      switch (get_from_opcode(opcode_, 0x00FF)) {
-        case 0x9E:
-          instructions_->skp_Ex9E(get_from_opcode(opcode_, 0x0F00));
-          return;
-        case 0xA1:
-          instructions_->sknp_ExA1(get_from_opcode(opcode_, 0x0F00));
-          return;
+        instructions_->jp_Bnnn(op::nnn(opcode_));
       }
       break;
-    case 0xF:
-      switch (get_from_opcode(opcode_, 0x00FF)) {
-        case 0x07:
-          instructions_->ld_Fx07(get_from_opcode(opcode_, 0x0F00));
-          return;
-        case 0x0A:
-          instructions_->ld_Fx0A(get_from_opcode(opcode_, 0x0F00));
-          return;
-        case 0x15:
-          instructions_->ld_Fx15(get_from_opcode(opcode_, 0x0F00));
-          return;
-        case 0x18:
-          instructions_->ld_Fx18(get_from_opcode(opcode_, 0x0F00));
-          return;
-        case 0x1E:
-          instructions_->add_Fx1E(get_from_opcode(opcode_, 0x0F00));
-          return;
-        case 0x29:
-          instructions_->ld_Fx29(get_from_opcode(opcode_, 0x0F00));
-          return;
-        case 0x33:
-          instructions_->ld_Fx33(get_from_opcode(opcode_, 0x0F00));
-          return;
-        case 0x55:
-          instructions_->ld_Fx55(get_from_opcode(opcode_, 0x0F00));
-          return;
-        case 0x65:
-          instructions_->ld_Fx65(get_from_opcode(opcode_, 0x0F00));
-          return;
+    case op::Handler::rnd_Cxkk:
+      instructions_->rnd_Cxkk(op::x(opcode_), op::kk(opcode_));
+      break;
+    case op::Handler::drw_Dxyn:
+      instructions_->drw_Dxyn(op::x(opcode_), op::y(opcode_), op::n(opcode_));
+      break;
+    case op::Handler::skp_Ex9E:
+      instructions_->skp_Ex9E(op::x(opcode_));
+      break;
+    case op::Handler::sknp_ExA1:
+      instructions_->sknp_ExA1(op::x(opcode_));
+      break;
+    case op::Handler::ld_F000:
+      // The address is stored in the 2 bytes following the instruction.
+      if (static_cast<unsigned int>(registers_->pc_.peek()) + 1 >= mem::MEMORY_SIZE) {
+        registers_->raise(Fault::address_out_of_range);
+        break;
       }
+      instructions_->ld_F000((memory_->peek(registers_->pc_.peek()) << 8) +
+                             memory_->peek(registers_->pc_.peek() + 1));
+      registers_->pc_.increment(2);
+      break;
+    case op::Handler::plane_Fn01:
+      instructions_->plane_Fn01(op::x(opcode_));
+      break;
+    case op::Handler::audio_F002:
+      instructions_->audio_F002();
+      break;
+    case op::Handler::ld_Fx07:
+      instructions_->ld_Fx07(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx0A:
+      instructions_->ld_Fx0A(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx15:
+      instructions_->ld_Fx15(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx18:
+      instructions_->ld_Fx18(op::x(opcode_));
+      break;
+    case op::Handler::add_Fx1E:
+      instructions_->add_Fx1E(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx29:
+      instructions_->ld_Fx29(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx30:
+      instructions_->ld_Fx30(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx33:
+      instructions_->ld_Fx33(op::x(opcode_));
+      break;
+    case op::Handler::pitch_Fx3A:
+      instructions_->pitch_Fx3A(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx55:
+      instructions_->ld_Fx55(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx65:
+      instructions_->ld_Fx65(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx75:
+      instructions_->ld_Fx75(op::x(opcode_));
+      break;
+    case op::Handler::ld_Fx85:
+      instructions_->ld_Fx85(op::x(opcode_));
+      break;
+    case op::Handler::unknown:
+    case op::Handler::count:
+      registers_->raise(Fault::unknown_opcode);
       break;
   }
-
-  ss << "0x" << std::hex << opcode_;
-  throw std::runtime_error("UNKNOW OPCODE: " + ss.str());
+  // faulted_ may still be set by an earlier instruction
+  return record_faults(faults) ? registers_->fault_ : Fault::none;
 }
 
 uint16_t RomParser::get_from_opcode(const uint16_t & opcode, const uint16_t mask) {
@@ -191,6 +242,251 @@ uint16_t RomParser::get_from_opcode(const uint16_t & opcode, const uint16_t mask
   return (opcode & mask) >> c;
 }
 
+unsigned short int RomParser::skip_idle(unsigned short int max) {
+  if (op::TABLE[opcode_] != op::Handler::jp_1nnn) { return 0; }
+
+  mem::address_t target = op::nnn(opcode_);
+  unsigned short int period;
+  bool polls_delay_timer = false;
+  reg::regnb_t vx = 0x0;
+
+  if (target == opcode_address_) {
+    // 1nnn jumping to itself
+    period = 1;
+  } else if (target == opcode_address_ - 4) {
+    // Fx07, 3xkk, 1nnn polling the delay timer until it reaches kk
+    uint16_t load = (memory_->peek(target) << 8) + memory_->peek(target + 1);
+    uint16_t skip = (memory_->peek(target + 2) << 8) + memory_->peek(target + 3);
+    vx = op::x(load);
+
+    if (op::TABLE[load] != op::Handler::ld_Fx07 || op::TABLE[skip] != op::Handler::se_3xkk) {
+      return 0;
+    }
+    if (op::x(skip) != vx) { return 0; }
+    if (registers_->dt_.peek() == op::kk(skip)) { return 0; }
+    period = 3;
+    polls_delay_timer = true;
+  } else {
+    return 0;
+  }
+
+  // Whole iterations only, stopping before the cycle that decrements the timers.
+  unsigned short int remaining = registers_->cycles_to_next_tick();
+  if (remaining == 0) { return 0; }
+  unsigned short int skipped = std::min<unsigned short int>(remaining - 1, max) / period * period;
+  if (skipped == 0) { return 0; }
+
+  registers_->skip_cycles(skipped);
+  if (polls_delay_timer) { registers_->v_[vx].poke(registers_->dt_.peek()); }
+  return skipped;
+}
+
+unsigned int RomParser::run(unsigned int cycles) {
+  unsigned int elapsed = 0;
+
+  while (elapsed < cycles && !registers_->exited_ && !registers_->faulted_) {
+    registers_->trigger_timers();
+    elapsed++;
+
+    if (!instructions_->resume_Fx0A()) {
+      registers_->elapse(cycles - elapsed);
+      return elapsed - 1;
+    }
+
+    if (native_enabled_) {
+      // As fuse(), the instructions after the first one run within the same timer period.
+      unsigned short int remaining = registers_->cycles_to_next_tick();
+      unsigned int span = remaining == 0 ? cycles - elapsed
+                                         : std::min<unsigned int>(remaining - 1, cycles - elapsed);
+      unsigned int executed = run_native(span + 1);
+      if (executed > 0) {
+        registers_->elapse(executed - 1);
+        elapsed += executed - 1;
+        fusion_stats_.dispatches++;
+        fusion_stats_.instructions += executed;
+        if (registers_->faulted_ && stops_on_fault()) { return elapsed; }
+        continue;
+      }
+    }
+
+    unsigned short int fused = 0;
+    if (step() == Fault::none) {
+      if (configuration_->isFusion()) {
+        fused = fuse(std::min<unsigned int>(cycles - elapsed, 0xFFFF));
+      }
+      if (fused == 0) { decode(); }
+    }
+    elapsed += fused;
+    fusion_stats_.dispatches++;
+    fusion_stats_.instructions += fused + 1;
+    if (registers_->faulted_ && stops_on_fault()) { return elapsed; }
+
+    if (configuration_->isIdleSkip()) {
+      elapsed += skip_idle(std::min<unsigned int>(cycles - elapsed, 0xFFFF));
+    }
+  }
+  return elapsed;
+}
+
+bool RomParser::stops_on_fault() {
+  switch (configuration_->getFaultPolicy()) {
+    case FaultPolicy::ignore:
+      registers_->faulted_ = false;
+      return false;
+    case FaultPolicy::trap:
+      // A debugger has nothing to show for a frame that is thrown away
+      if (!speculative_) { std::raise(SIGTRAP); }
+      break;
+    case FaultPolicy::halt:
+      break;
+  }
+  return true;
+}
+
+unsigned short int RomParser::fuse(unsigned short int max) {
+  unsigned long faults = registers_->faults_;
+  op::Handler first = op::TABLE[opcode_];
+  if (first != op::Handler::ld_Annn && first != op::Handler::ld_6xkk &&
+      first != op::Handler::add_7xkk && first != op::Handler::ld_Fx07) {
+    return 0;
+  }
+
+  // Every instruction of a sequence runs within the same timer period.
+  unsigned short int remaining = registers_->cycles_to_next_tick();
+  unsigned short int span = remaining == 0 ? max : std::min<unsigned short int>(remaining - 1, max);
+  if (span == 0) { return 0; }
+
+  mem::address_t address = registers_->pc_.peek();
+  uint16_t last = peek_opcode(address);
+  op::Handler second = op::TABLE[last];
+  bool same_x = op::x(last) == op::x(opcode_);
+  unsigned short int extra = 1;
+  op::Fusion fusion;
+
+  if (first == op::Handler::ld_Annn && second == op::Handler::drw_Dxyn) {
+    fusion = op::Fusion::ld_drw_Annn_Dxyn;
+    registers_->pc_.increment(2);
+    instructions_->ld_drw_Annn_Dxyn(op::nnn(opcode_), op::x(last), op::y(last), op::n(last));
+  } else if (first == op::Handler::ld_6xkk && second == op::Handler::ld_Fx15 && same_x) {
+    fusion = op::Fusion::ld_ld_6xkk_Fx15;
+    registers_->pc_.increment(2);
+    instructions_->ld_ld_6xkk_Fx15(op::x(opcode_), op::kk(opcode_));
+  } else if (first == op::Handler::add_7xkk && second == op::Handler::se_3xkk && same_x) {
+    fusion = op::Fusion::add_se_7xkk_3xkk;
+    registers_->pc_.increment(2);
+    instructions_->add_se_7xkk_3xkk(op::x(opcode_), op::kk(opcode_), op::kk(last));
+  } else if (first == op::Handler::add_7xkk && second == op::Handler::sne_4xkk && same_x) {
+    fusion = op::Fusion::add_sne_7xkk_4xkk;
+    registers_->pc_.increment(2);
+    instructions_->add_sne_7xkk_4xkk(op::x(opcode_), op::kk(opcode_), op::kk(last));
+  } else if (first == op::Handler::ld_Fx07 && second == op::Handler::se_3xkk && same_x &&
+             span >= 2) {
+    uint16_t jump = peek_opcode(address + 2);
+    if (op::TABLE[jump] != op::Handler::jp_1nnn) { return 0; }
+
+    fusion = op::Fusion::ld_se_jp_Fx07_3xkk_1nnn;
+    registers_->pc_.increment(2);
+    if (instructions_->ld_se_jp_Fx07_3xkk_1nnn(op::x(opcode_), op::kk(last), op::nnn(jump))) {
+      // The 1nnn was executed too, skip_idle() can fast-forward the poll from there.
+      extra = 2;
+      address += 2;
+      last = jump;
+    }
+  } else {
+    return 0;
+  }
+
+  opcode_address_ = address;
+  opcode_ = last;
+  record_faults(faults);
+  registers_->elapse(extra);
+  fusion_stats_.fused[static_cast<size_t>(fusion)]++;
+  return extra;
+}
+
+void RomParser::load_native(const std::string & path) {
+  native_ = std::make_shared<NativeCode>(path, rom_hash_);
+  native_state_.exec = exec_native;
+  native_state_.user = this;
+  native_enabled_ = true;
+}
+
+bool RomParser::is_native() const {
+  return native_enabled_;
+}
+
+unsigned int RomParser::run_native(unsigned int max) {
+  store_native_state();
+  unsigned int executed = native_->run(native_state_, max);
+  if (executed > 0) { load_native_state(); }
+  return executed;
+}
+
+void RomParser::store_native_state() {
+  for (uint8_t v = 0; v < 0x10; v++) { native_state_.v[v] = registers_->v_[v].peek(); }
+  native_state_.i = registers_->i_.peek();
+  native_state_.pc = registers_->pc_.peek();
+  native_state_.dt = registers_->dt_.peek();
+}
+
+void RomParser::load_native_state() {
+  for (uint8_t v = 0; v < 0x10; v++) { registers_->v_[v].poke(native_state_.v[v]); }
+  registers_->i_.poke(native_state_.i);
+  registers_->pc_.poke(native_state_.pc);
+  registers_->dt_.poke(native_state_.dt);
+}
+
+int RomParser::exec_native(chip8_aot_state * state, uint16_t opcode) {
+  RomParser * parser = static_cast<RomParser *>(state->user);
+  parser->load_native_state();
+  parser->opcode_ = opcode;
+  parser->opcode_address_ = state->pc - 2;
+  mem::address_t i = parser->registers_->i_.peek();
+  parser->decode();
+
+  // The native code is left for good once the program overwrites it.
+  unsigned int written = 0;
+  switch (op::TABLE[opcode]) {
+    case op::Handler::ld_Fx33:
+      written = 3;
+      break;
+    case op::Handler::ld_Fx55:
+      written = op::x(opcode) + 1;
+      break;
+    case op::Handler::ld_5xy2:
+      written = std::abs(op::x(opcode) - op::y(opcode)) + 1;
+      break;
+    default:
+      break;
+  }
+  if (written > 0 && parser->native_->is_code(i, written)) { parser->native_enabled_ = false; }
+
+  parser->store_native_state();
+  return parser->registers_->halted_ || parser->registers_->exited_ ||
+         parser->registers_->faulted_ || !parser->native_enabled_;
+}
+
+const FusionStats & RomParser::get_fusion_stats() const {
+  return fusion_stats_;
+}
+
+uint16_t RomParser::peek_opcode(mem::address_t address) {
+  if (static_cast<unsigned int>(address) + 1 >= mem::MEMORY_SIZE) { return 0x0000; }
+  return (memory_->peek(address) << 8) + memory_->peek(address + 1);
+}
+
+void RomParser::set_speculative(bool speculative) {
+  speculative_ = speculative;
+  instructions_->set_speculative(speculative);
+}
+
 void RomParser::set_opcode(uint16_t opcode) {
   opcode_ = opcode;
+  opcode_address_ = registers_->pc_.peek() - 2;
+}
+
+bool RomParser::record_faults(unsigned long faults) {
+  if (registers_->faults_ == faults) { return false; }
+  registers_->fault_address_ = opcode_address_;
+  return true;
 }
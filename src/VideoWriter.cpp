@@ -0,0 +1,133 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "VideoWriter.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  // Sleep of the writer thread when the queue is empty, shorter than a frame
+  const std::chrono::milliseconds IDLE_WAIT{2};
+  const char FRAME_HEADER[] = "FRAME\n";
+}// namespace
+
+VideoWriter::VideoWriter(const std::string & path)
+    : output_(path == "-" ? STDOUT_FILENO
+                          : open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) {
+  if (output_ < 0) {
+    throw std::runtime_error("Unable to open " + path + ": " + std::strerror(errno));
+  }
+  // A reader closing the pipe ends the video, not the process
+  std::signal(SIGPIPE, SIG_IGN);
+  struct stat status {};
+  if (fstat(output_, &status) == 0 && S_ISFIFO(status.st_mode)) {
+    blocking_flags_ = fcntl(output_, F_GETFL);
+    if (blocking_flags_ >= 0) { fcntl(output_, F_SETFL, blocking_flags_ | O_NONBLOCK); }
+  }
+
+  char header[64];
+  int size = std::snprintf(header, sizeof(header), "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 Cmono\n",
+                           WIDTH, HEIGHT, FRAME_RATE);
+  if (!write_all(header, size)) { failed_ = true; }
+  writer_ = std::thread(&VideoWriter::write_frames, this);
+}
+
+VideoWriter::~VideoWriter() {
+  finish();
+}
+
+void VideoWriter::finish() {
+  if (!writer_.joinable()) { return; }
+  stop_deadline_ = std::chrono::steady_clock::now() + FINISH_TIMEOUT;
+  stop_ = true;
+  writer_.join();
+  failed_ = true;
+  if (blocking_flags_ >= 0) { fcntl(output_, F_SETFL, blocking_flags_); }
+  if (output_ != STDOUT_FILENO) { close(output_); }
+}
+
+bool VideoWriter::push(const Display & display) {
+  if (failed_) {
+    dropped_++;
+    return false;
+  }
+
+  if (!frame_valid_ || display.get_hash() != display_hash_) {
+    // Low resolution pixels are 2x2 pixels of the frame
+    unsigned short int scale = display.is_hires() ? 1 : 2;
+    for (unsigned short int y = 0; y < HEIGHT; y++) {
+      for (unsigned short int x = 0; x < WIDTH; x++) {
+        frame_[y * WIDTH + x] = get_gray(display.get_color(x / scale, y / scale));
+      }
+    }
+    display_hash_ = display.get_hash();
+    frame_valid_ = true;
+  }
+
+  if (!frames_.push(frame_)) {
+    dropped_++;
+    return false;
+  }
+  return true;
+}
+
+VideoStats VideoWriter::get_stats() const {
+  return {written_, dropped_};
+}
+
+uint8_t VideoWriter::get_gray(uint8_t color) {
+  uint32_t argb = PALETTE[color & 0xF];
+  uint32_t red = (argb >> 16) & 0xFF, green = (argb >> 8) & 0xFF, blue = argb & 0xFF;
+  return static_cast<uint8_t>((299 * red + 587 * green + 114 * blue + 500) / 1000);
+}
+
+void VideoWriter::write_frames() {
+  frame_t frame;
+  for (;;) {
+    if (!frames_.pop(frame)) {
+      if (!stop_) {
+        std::this_thread::sleep_for(IDLE_WAIT);
+        continue;
+      }
+      // Frames pushed right before the stop request
+      if (!frames_.pop(frame)) { return; }
+    }
+    if (failed_) {
+      dropped_++;
+      continue;
+    }
+    if (!write_all(FRAME_HEADER, sizeof(FRAME_HEADER) - 1) ||
+        !write_all(reinterpret_cast<const char *>(frame.data()), frame.size())) {
+      failed_ = true;
+      dropped_++;
+      continue;
+    }
+    written_++;
+  }
+}
+
+bool VideoWriter::write_all(const char * data, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(output_, data, size);
+    if (written >= 0) {
+      data += written;
+      size -= written;
+      continue;
+    }
+    if (errno == EINTR) { continue; }
+    if (errno != EAGAIN && errno != EWOULDBLOCK) { return false; }
+    if (stop_ && std::chrono::steady_clock::now() >= stop_deadline_) { return false; }
+    // The pipe is full, wait for the reader
+    pollfd ready{output_, POLLOUT, 0};
+    poll(&ready, 1, IDLE_WAIT.count());
+  }
+  return true;
+}
@@ -0,0 +1,46 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include "Recompiler.h"
+#include "tclap/CmdLine.h"
+
+int main(int argc, char ** argv) {
+  // Argument parsing with TCLAP
+  try {
+    TCLAP::CmdLine cmd("CHIP8 ahead-of-time recompiler, translates a ROM to C++ to be compiled "
+                       "into a shared object loaded by CHIP8 --native",
+                       ' ', "0.1");
+    TCLAP::ValueArg<std::string> output_arg("o", "output",
+                                            "C++ file to write (Default: standard output)", false,
+                                            "", "path");
+    cmd.add(output_arg);
+    TCLAP::UnlabeledValueArg<std::string> rom_path_arg("rom_path", "Path to CHIP8 rom.", true, "",
+                                                       "Path");
+    cmd.add(rom_path_arg);
+    cmd.parse(argc, argv);
+
+    std::ifstream source(rom_path_arg.getValue(), std::ios_base::binary);
+    if (!source) {
+      std::cerr << "error: Unable to open rom." << std::endl;
+      return 1;
+    }
+    std::vector<uint8_t> rom((std::istreambuf_iterator<char>(source)),
+                             std::istreambuf_iterator<char>());
+
+    Recompiler recompiler(rom);
+    if (output_arg.getValue().empty()) {
+      recompiler.emit(std::cout, rom_path_arg.getValue());
+    } else {
+      std::ofstream output(output_arg.getValue());
+      recompiler.emit(output, rom_path_arg.getValue());
+    }
+  } catch (TCLAP::ArgException & e) {
+    std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,166 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "chip8.h"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "Batch.h"
+#include "Machine.h"
+#include "QuirkDatabase.h"
+
+namespace {
+  const mem::address_t ROM_START = 0x200;
+  static_assert(CHIP8_ROWS == Display::MAX_SIZE_Y && CHIP8_ROW_BYTES == sizeof(Display::row_t),
+                "The frame buffer layout is part of the API");
+  static_assert(static_cast<int>(Status::faulted) == CHIP8_FAULTED &&
+                        static_cast<int>(Status::exited) == CHIP8_EXITED &&
+                        static_cast<int>(Status::halted) == CHIP8_HALTED &&
+                        static_cast<int>(Status::running) == CHIP8_RUNNING,
+                "Batch statuses are returned as is");
+  static_assert(quirk::SHIFT_SETS_VY == CHIP8_QUIRK_SHIFT_SETS_VY &&
+                        quirk::JUMP_USES_VX == CHIP8_QUIRK_JUMP_USES_VX &&
+                        quirk::LOAD_STORE_INCREMENTS_I == CHIP8_QUIRK_LOAD_STORE_INCREMENTS_I &&
+                        quirk::LOGIC_RESETS_VF == CHIP8_QUIRK_LOGIC_RESETS_VF,
+                "Quirk flags are passed as is");
+
+  std::shared_ptr<Configuration> make_configuration(unsigned int frequency, unsigned int quirks,
+                                                    unsigned int seed) {
+    // Stored in 16 bits, and the timers never tick below 60 Hz
+    if (frequency < CHIP8_MIN_FREQUENCY || frequency > CHIP8_MAX_FREQUENCY) {
+      throw std::runtime_error("Frequency out of range");
+    }
+    std::shared_ptr<Configuration> configuration =
+            quirk::make_configuration("", frequency, quirks);
+    configuration->setSeed(seed);
+    return configuration;
+  }
+}// namespace
+
+/**
+ * The C handle, a headless machine and the state chip8_load_rom() resets it to.
+ */
+struct chip8 {
+  explicit chip8(const std::shared_ptr<Configuration> & configuration)
+      : core(configuration, false), initial(core.save()) {}
+
+  Machine core;
+  const Snapshot initial;
+};
+
+unsigned int chip8_get_api_version() {
+  return CHIP8_API_VERSION;
+}
+
+chip8 * chip8_create(unsigned int frequency, unsigned int quirks, unsigned int seed) {
+  // No exception may cross the C interface
+  try {
+    return new chip8(make_configuration(frequency, quirks, seed));
+  } catch (const std::exception &) { return nullptr; }
+}
+
+void chip8_destroy(chip8 * machine) {
+  delete machine;
+}
+
+int chip8_load_rom(chip8 * machine, const uint8_t * rom, size_t size) {
+  if (size > mem::MEMORY_SIZE - ROM_START) { return -1; }
+  machine->core.restore(machine->initial);
+  machine->core.romParser_->load(std::vector<uint8_t>(rom, rom + size));
+  return 0;
+}
+
+unsigned int chip8_run_cycles(chip8 * machine, unsigned int cycles) {
+  return machine->core.romParser_->run(cycles);
+}
+
+unsigned int chip8_run_frame(chip8 * machine) {
+  const reg::RegisterManager & registers = *machine->core.registers_;
+  return chip8_run_cycles(machine, std::max<unsigned int>(registers.cycles_to_next_tick(), 1));
+}
+
+void chip8_set_keys(chip8 * machine, uint16_t keys) {
+  machine->core.interface_->keypad_->set_mask(keys);
+}
+
+int chip8_get_status(const chip8 * machine) {
+  const reg::RegisterManager & registers = *machine->core.registers_;
+  if (registers.faulted_) { return CHIP8_FAULTED; }
+  if (registers.exited_) { return CHIP8_EXITED; }
+  if (registers.halted_) { return CHIP8_HALTED; }
+  return CHIP8_RUNNING;
+}
+
+const char * chip8_get_fault(const chip8 * machine) {
+  const reg::RegisterManager & registers = *machine->core.registers_;
+  if (registers.faults_ == 0) { return nullptr; }
+  return FAULT_NAMES[static_cast<size_t>(registers.fault_)];
+}
+
+int chip8_is_buzzing(const chip8 * machine) {
+  return machine->core.registers_->st_.peek() > 0;
+}
+
+unsigned int chip8_get_width(const chip8 * machine) {
+  return machine->core.interface_->display_->size_x();
+}
+
+unsigned int chip8_get_height(const chip8 * machine) {
+  return machine->core.interface_->display_->size_y();
+}
+
+unsigned int chip8_get_planes(const chip8 * machine) {
+  const Display & display = *machine->core.interface_->display_;
+  return display.PLANES;
+}
+
+const uint8_t * chip8_get_plane(const chip8 * machine, unsigned int plane) {
+  if (plane >= Display::PLANES) { return nullptr; }
+  const Display & display = *machine->core.interface_->display_;
+  return reinterpret_cast<const uint8_t *>(display.get_plane(plane));
+}
+
+uint64_t chip8_get_state_hash(const chip8 * machine) {
+  return machine->core.get_hash();
+}
+
+struct chip8_batch {
+  Batch batch;
+};
+
+chip8_batch * chip8_batch_create(size_t size, unsigned int threads, unsigned int frequency,
+                                 unsigned int quirks, unsigned int seed, const uint8_t * rom,
+                                 size_t rom_size) {
+  try {
+    return new chip8_batch{{make_configuration(frequency, quirks, seed),
+                            std::vector<uint8_t>(rom, rom + rom_size), size, threads}};
+  } catch (const std::exception &) { return nullptr; }
+}
+
+void chip8_batch_destroy(chip8_batch * batch) {
+  delete batch;
+}
+
+void chip8_batch_step(chip8_batch * batch, const uint16_t * actions) {
+  batch->batch.step(actions);
+}
+
+void chip8_batch_reset(chip8_batch * batch, size_t index) {
+  batch->batch.reset(index);
+}
+
+const uint8_t * chip8_batch_get_observations(const chip8_batch * batch) {
+  return reinterpret_cast<const uint8_t *>(batch->batch.get_observations());
+}
+
+const uint8_t * chip8_batch_get_status(const chip8_batch * batch) {
+  return reinterpret_cast<const uint8_t *>(batch->batch.get_status());
+}
+
+const uint64_t * chip8_batch_get_hashes(const chip8_batch * batch) {
+  return batch->batch.get_hashes();
+}
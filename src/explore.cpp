@@ -0,0 +1,115 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Explorer.h"
+#include "QuirkDatabase.h"
+#include "tclap/CmdLine.h"
+
+namespace {
+  void print(const Finding & finding) {
+    std::printf("  %-5s at 0x%03X", FINDING_NAMES[static_cast<size_t>(finding.kind)], finding.pc);
+    if (finding.kind == FindingKind::fault) {
+      std::printf(" (%s)", FAULT_NAMES[static_cast<size_t>(finding.fault)]);
+    }
+    std::printf(" after %zu inputs:", finding.inputs.size());
+    for (uint16_t input : finding.inputs) { std::printf(" %04X", input); }
+    std::printf("\n");
+  }
+}// namespace
+
+int main(int argc, char ** argv) {
+  // Argument parsing with TCLAP
+  try {
+    TCLAP::CmdLine cmd("CHIP8 explorer, searches the keypad inputs that make a ROM fault or hang, "
+                       "running it headless from snapshots of the states reached",
+                       ' ', "0.1");
+    TCLAP::ValueArg<unsigned int> depth_arg("d", "depth",
+                                            "Most inputs applied in a row (Default: 50)", false,
+                                            50, "inputs");
+    cmd.add(depth_arg);
+    TCLAP::ValueArg<double> seconds_arg("t", "time", "Time limit in seconds (Default: 60)", false,
+                                        60.0, "seconds");
+    cmd.add(seconds_arg);
+    TCLAP::ValueArg<size_t> beam_arg(
+            "b", "beam",
+            "States kept per input, the ones running the most new instructions, 0 to keep them "
+            "all (Default: 1000)",
+            false, 1000, "states");
+    cmd.add(beam_arg);
+    TCLAP::ValueArg<unsigned int> frames_arg("n", "frames", "Frames each input is held for "
+                                             "(Default: 4)",
+                                             false, 4, "frames");
+    cmd.add(frames_arg);
+    TCLAP::ValueArg<unsigned int> threads_arg(
+            "j", "threads", "States expanded at once (Default: one per hardware thread)", false,
+            std::max(std::thread::hardware_concurrency(), 1U), "threads");
+    cmd.add(threads_arg);
+    TCLAP::ValueArg<int> freq_arg("f", "Frequency", "CPU Frequency (Default: 500Hz)", false, 500,
+                                  "value");
+    cmd.add(freq_arg);
+    TCLAP::ValueArg<unsigned int> seed_arg("s", "seed", "Seed of the random numbers (Default: 1)",
+                                           false, 1, "value");
+    cmd.add(seed_arg);
+    TCLAP::ValueArg<std::string> quirks_arg(
+            "q", "quirks",
+            "Quirks -1 to -4, as 1--4 (Default: the ones of the ROM in " + DEFAULT_QUIRK_DATABASE +
+                    ", or none)",
+            false, "", "quirks");
+    cmd.add(quirks_arg);
+    TCLAP::UnlabeledValueArg<std::string> rom_path_arg("rom_path", "Path to a CHIP8 rom.", true,
+                                                       "", "Path");
+    cmd.add(rom_path_arg);
+    cmd.parse(argc, argv);
+
+    const std::string & path = rom_path_arg.getValue();
+    std::ifstream source(path, std::ios_base::binary);
+    if (!source) { throw std::runtime_error("Unable to open " + path + "."); }
+    std::vector<uint8_t> rom((std::istreambuf_iterator<char>(source)),
+                             std::istreambuf_iterator<char>());
+
+    unsigned int quirks = 0x0;
+    if (quirks_arg.isSet()) {
+      quirks = quirk::parse(quirks_arg.getValue());
+    } else if (auto found = QuirkDatabase(DEFAULT_QUIRK_DATABASE).find_rom(path)) {
+      quirks = *found;
+    }
+    std::shared_ptr<Configuration> configuration =
+            quirk::make_configuration(path, freq_arg.getValue(), quirks);
+    configuration->setSeed(seed_arg.getValue());
+
+    Explorer explorer(configuration, rom, threads_arg.getValue(), beam_arg.getValue(),
+                      frames_arg.getValue());
+    std::printf("%s, quirks %s\n", path.c_str(), quirk::format(quirks).c_str());
+    std::printf("  depth    states  frontier  PCs  PCs/s\n");
+    size_t reported = 0;
+    bool more = true;
+    while (more && explorer.get_stats().depth < depth_arg.getValue() &&
+           explorer.get_stats().seconds < seconds_arg.getValue()) {
+      more = explorer.expand();
+      const ExplorerStats & stats = explorer.get_stats();
+      std::printf("  %5u  %8zu  %8zu  %4zu  %5.0f\n", stats.depth, stats.states, stats.frontier,
+                  stats.unique_pcs, stats.unique_pcs / stats.seconds);
+      for (; reported < explorer.get_findings().size(); reported++) {
+        print(explorer.get_findings()[reported]);
+      }
+    }
+
+    for (const Finding & finding : explorer.get_findings()) {
+      if (finding.kind != FindingKind::exit) { return 1; }
+    }
+    return 0;
+  } catch (TCLAP::ArgException & e) {
+    std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+  } catch (const std::runtime_error & e) {
+    std::cerr << "error: " << e.what() << std::endl;
+  }
+  return 1;
+}
@@ -1,13 +1,45 @@
 // (c) 2021 Maxandre Ogeret
 // Licensed under MIT License
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "Configuration.h"
 #include "Interpreter.h"
+#include "Lockstep.h"
+#include "QuirkDatabase.h"
 #include "tclap/CmdLine.h"
 
+namespace {
+  /**
+   * Accepts the integers of a closed range.
+   */
+  class RangeConstraint : public TCLAP::Constraint<int> {
+  public:
+    RangeConstraint(int min, int max) : min_(min), max_(max) {}
+
+    std::string description() const override {
+      return "from " + std::to_string(min_) + " to " + std::to_string(max_);
+    }
+
+    std::string shortID() const override {
+      return "value";
+    }
+
+    bool check(const int & value) const override {
+      return value >= min_ && value <= max_;
+    }
+
+  private:
+    int min_, max_;
+  };
+}// namespace
+
 int main(int argc, char ** argv) {
   // Argument parsing with TCLAP
   try {
@@ -15,6 +47,10 @@ int main(int argc, char ** argv) {
                        "MIT License Copyright (c) 2021 Maxandre Ogeret, "
                        "https://github.com/MaxandreOgeret/chip8_interpreter",
                        ' ', "0.1");
+    TCLAP::SwitchArg no_fusion_arg("", "no-fusion",
+                                   "Dispatch every instruction on its own, without "
+                                   "superinstructions.",
+                                   cmd, false);
     TCLAP::SwitchArg conf_4_arg("4", "4", "OR/AND/XOR 8xy1/8xy2/8xy3 will reset vf to 0.", cmd,
                                 false);
     TCLAP::SwitchArg conf_3_arg("3", "3", "Store/Load Fx55/Fx65 will increment i.", cmd, false);
@@ -27,19 +63,144 @@ int main(int argc, char ** argv) {
     TCLAP::ValueArg<int> freq_arg("f", "Frequency", "CPU Frequency (Default: 500Hz)", false, 500,
                                   "value");
     cmd.add(freq_arg);
+    TCLAP::ValueArg<std::string> keymap_arg(
+            "k", "keymap",
+            "Keyboard keys bound to the keypad keys 0 to F (Default: " + DEFAULT_KEYMAP + ")",
+            false, DEFAULT_KEYMAP, "keys");
+    cmd.add(keymap_arg);
+    RangeConstraint sample_rate_constraint(8000, 192000);
+    TCLAP::ValueArg<int> sample_rate_arg("r", "sample-rate",
+                                         "Audio sample rate, 8000Hz to 192000Hz (Default: 20000Hz)",
+                                         false, 20000, &sample_rate_constraint);
+    cmd.add(sample_rate_arg);
+    // The device buffer size is 16-bit
+    RangeConstraint buffer_constraint(16, 16384);
+    TCLAP::ValueArg<int> buffer_arg("b", "audio-buffer",
+                                    "Audio buffer size, 16 to 16384 samples, lower is more "
+                                    "responsive (Default: 100 samples)",
+                                    false, 100, &buffer_constraint);
+    cmd.add(buffer_arg);
+    TCLAP::ValueArg<std::string> native_arg(
+            "n", "native", "Shared object compiled from the ROM by CHIP8_AOT", false, "", "path");
+    cmd.add(native_arg);
+    TCLAP::ValueArg<unsigned int> seed_arg("s", "seed", "Seed of the random numbers (Default: random)",
+                                           false, 0, "value");
+    cmd.add(seed_arg);
+    TCLAP::ValueArg<unsigned long> lockstep_arg(
+            "", "lockstep",
+            "Run headless for this many cycles, checking the selected core against the reference "
+            "interpreter, and print the first divergence",
+            false, 0, "cycles");
+    cmd.add(lockstep_arg);
+    TCLAP::ValueArg<unsigned int> interval_arg(
+            "", "lockstep-interval",
+            "Cycles between two lockstep checks. 1 checks every instruction, but never runs "
+            "superinstructions or skips idle loops (Default: one timer period)",
+            false, 0, "cycles");
+    cmd.add(interval_arg);
+    TCLAP::ValueArg<unsigned int> frameskip_arg(
+            "", "max-frameskip",
+            "Most frames skipped in a row when the host falls behind real time (Default: 4)",
+            false, 4, "frames");
+    cmd.add(frameskip_arg);
+    TCLAP::ValueArg<unsigned int> run_ahead_arg(
+            "", "run-ahead",
+            "Frames emulated ahead of the one displayed, hiding as many frames of input latency "
+            "(Default: 0)",
+            false, 0, "frames");
+    cmd.add(run_ahead_arg);
+    std::vector<std::string> policies = {"halt", "trap", "ignore"};
+    TCLAP::ValuesConstraint<std::string> policy_constraint(policies);
+    TCLAP::ValueArg<std::string> fault_arg(
+            "", "on-fault",
+            "What the CPU does when the program faults: halt, trap to the debugger with SIGTRAP, "
+            "or ignore the faulting instruction (Default: halt)",
+            false, "halt", &policy_constraint);
+    cmd.add(fault_arg);
+    TCLAP::ValueArg<std::string> quirk_db_arg(
+            "", "quirk-db",
+            "Quirk database written by CHIP8_QUIRKS, giving the quirks of the ROMs it lists when "
+            "no quirk switch is set (Default: " + DEFAULT_QUIRK_DATABASE + ")",
+            false, DEFAULT_QUIRK_DATABASE, "path");
+    cmd.add(quirk_db_arg);
+    TCLAP::ValueArg<std::string> shm_arg(
+            "", "shm",
+            "Publish every frame, the keys and the core counters to this POSIX shared memory "
+            "object, as /chip8, for other processes to read",
+            false, "", "name");
+    cmd.add(shm_arg);
+    TCLAP::ValueArg<std::string> video_arg(
+            "", "video-out",
+            "Record every frame as a 128x64 grayscale Y4M video to this file or FIFO, - for the "
+            "standard output. Frames are dropped when the reader is too slow",
+            false, "", "path");
+    cmd.add(video_arg);
     TCLAP::UnlabeledValueArg<std::string> rom_path_arg("rom_path", "Path to CHIP8 rom.", true, "",
                                                        "Path");
     cmd.add(rom_path_arg);
     cmd.parse(argc, argv);
+    // The video owns the standard output, the messages go to the standard error
+    if (video_arg.getValue() == "-") { std::cout.rdbuf(std::cerr.rdbuf()); }
+
+    unsigned int quirks = (conf_1_arg.getValue() ? quirk::SHIFT_SETS_VY : 0) |
+                          (conf_2_arg.getValue() ? quirk::JUMP_USES_VX : 0) |
+                          (conf_3_arg.getValue() ? quirk::LOAD_STORE_INCREMENTS_I : 0) |
+                          (conf_4_arg.getValue() ? quirk::LOGIC_RESETS_VF : 0);
+    if (quirks == 0) {
+      try {
+        QuirkDatabase database(quirk_db_arg.getValue());
+        std::optional<unsigned int> found = database.find_rom(rom_path_arg.getValue());
+        if (found) {
+          quirks = *found;
+          std::cout << "Quirks " << quirk::format(quirks) << " from " << quirk_db_arg.getValue()
+                    << "\n";
+        }
+      } catch (const std::runtime_error & e) { std::cerr << "warning: " << e.what() << "\n"; }
+    }
+
+    std::shared_ptr<Configuration> configuration =
+            quirk::make_configuration(rom_path_arg.getValue(), freq_arg.getValue(), quirks);
+    configuration->setKeymap(keymap_arg.getValue());
+    configuration->setAudioSampleRate(sample_rate_arg.getValue());
+    configuration->setAudioBufferSamples(buffer_arg.getValue());
+    configuration->setFusion(!no_fusion_arg.getValue());
+    configuration->setNativePath(native_arg.getValue());
+    configuration->setSeed(seed_arg.getValue());
+    configuration->setMaxFrameskip(frameskip_arg.getValue());
+    configuration->setRunAhead(run_ahead_arg.getValue());
+    configuration->setExportName(shm_arg.getValue());
+    configuration->setVideoPath(video_arg.getValue());
+    configuration->setFaultPolicy(fault_arg.getValue() == "trap"     ? FaultPolicy::trap
+                                  : fault_arg.getValue() == "ignore" ? FaultPolicy::ignore
+                                                                     : FaultPolicy::halt);
 
-    std::shared_ptr<Configuration> configuration = std::make_shared<Configuration>(
-            rom_path_arg.getValue(), freq_arg.getValue(), conf_1_arg.getValue(),
-            conf_2_arg.getValue(), conf_3_arg.getValue(), conf_4_arg.getValue());
+    if (lockstep_arg.getValue() > 0) {
+      // A whole timer period lets the superinstructions and the idle loop skipping run
+      unsigned int interval = std::max(configuration->getFrequency() / 60, 1);
+      if (interval_arg.isSet()) { interval = interval_arg.getValue(); }
+      Lockstep lockstep(configuration);
+      unsigned long cycles = lockstep.run(lockstep_arg.getValue(), interval);
+      if (lockstep.has_diverged()) {
+        std::cerr << lockstep.get_report();
+        return 1;
+      }
+      std::cout << "No divergence in " << cycles << " cycles, seed " << configuration->getSeed()
+                << "\n";
+      const reg::RegisterManager & registers = *lockstep.get_reference().registers_;
+      if (registers.faulted_) {
+        std::cout << "Fault: " << FAULT_NAMES[static_cast<size_t>(registers.fault_)] << " at 0x"
+                  << std::hex << registers.fault_address_ << std::dec << "\n";
+      }
+      return 0;
+    }
 
     std::unique_ptr<Interpreter> interpreter = std::make_unique<Interpreter>(configuration);
     interpreter->loop();
   } catch (TCLAP::ArgException & e) {
     std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+  } catch (const std::runtime_error & e) {
+    std::cerr << "error: " << e.what() << std::endl;
+    return 1;
   }
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "QuirkDatabase.h"
+#include "QuirkSweep.h"
+#include "tclap/CmdLine.h"
+
+namespace {
+  void print(const QuirkSweep & sweep) {
+    std::printf("  quirks  outcome     cycles  frame\n");
+    for (const QuirkResult & result : sweep.get_results()) {
+      std::printf("  %s    %-9s %8lu  %016llX", quirk::format(result.quirks).c_str(),
+                  OUTCOME_NAMES[static_cast<size_t>(result.outcome)], result.cycles,
+                  static_cast<unsigned long long>(result.display_digest));
+      if (result.outcome == Outcome::faulted) {
+        std::printf("  %s", FAULT_NAMES[static_cast<size_t>(result.fault)]);
+      }
+      if (result.diverged) { std::printf("  diverges at frame %lu", result.divergence_frame); }
+      std::printf("\n");
+    }
+  }
+}// namespace
+
+int main(int argc, char ** argv) {
+  // Argument parsing with TCLAP
+  try {
+    TCLAP::CmdLine cmd("CHIP8 quirk sweep, runs ROMs headless under the 16 quirk combinations and "
+                       "records the recommended one in the quirk database CHIP8 reads",
+                       ' ', "0.1");
+    TCLAP::ValueArg<unsigned long> cycles_arg("c", "cycles",
+                                              "Cycles run per combination (Default: 300000)",
+                                              false, 300000, "cycles");
+    cmd.add(cycles_arg);
+    TCLAP::ValueArg<int> freq_arg("f", "Frequency", "CPU Frequency (Default: 500Hz)", false, 500,
+                                  "value");
+    cmd.add(freq_arg);
+    TCLAP::ValueArg<unsigned int> threads_arg(
+            "j", "threads", "Combinations run at once (Default: one per hardware thread)", false,
+            std::max(std::thread::hardware_concurrency(), 1U), "threads");
+    cmd.add(threads_arg);
+    TCLAP::ValueArg<unsigned int> seed_arg("s", "seed",
+                                           "Seed of the random numbers and keys (Default: 1)",
+                                           false, 1, "value");
+    cmd.add(seed_arg);
+    TCLAP::ValueArg<std::string> database_arg(
+            "d", "database", "Quirk database to update (Default: " + DEFAULT_QUIRK_DATABASE + ")",
+            false, DEFAULT_QUIRK_DATABASE, "path");
+    cmd.add(database_arg);
+    TCLAP::SwitchArg dry_run_arg("", "dry-run", "Print the results without updating the database.",
+                                 cmd, false);
+    TCLAP::UnlabeledMultiArg<std::string> rom_paths_arg("rom_paths", "Paths to CHIP8 roms.", true,
+                                                        "Path");
+    cmd.add(rom_paths_arg);
+    cmd.parse(argc, argv);
+
+    QuirkDatabase database(database_arg.getValue());
+    int status = 0;
+    for (const std::string & path : rom_paths_arg.getValue()) {
+      std::ifstream source(path, std::ios_base::binary);
+      if (!source) {
+        std::cerr << "error: Unable to open " << path << "." << std::endl;
+        status = 1;
+        continue;
+      }
+      std::vector<uint8_t> rom((std::istreambuf_iterator<char>(source)),
+                               std::istreambuf_iterator<char>());
+
+      QuirkSweep sweep(rom, freq_arg.getValue(), seed_arg.getValue());
+      sweep.run(cycles_arg.getValue(), threads_arg.getValue());
+      std::printf("%s, hash %016llX\n", path.c_str(),
+                  static_cast<unsigned long long>(sweep.get_rom_hash()));
+      print(sweep);
+
+      if (sweep.is_ambiguous()) {
+        std::printf("  Ambiguous: the most common last frames are tied, nothing recorded.\n");
+        status = 1;
+        continue;
+      }
+      if (!sweep.get_recommended()) {
+        std::printf("  Every combination faulted.\n");
+        status = 1;
+        continue;
+      }
+      unsigned int quirks = *sweep.get_recommended();
+      std::printf("  Recommended: %s\n", quirk::format(quirks).c_str());
+      database.set(sweep.get_rom_hash(), quirks, path.substr(path.find_last_of('/') + 1));
+    }
+
+    if (!dry_run_arg.getValue()) { database.save(); }
+    return status;
+  } catch (TCLAP::ArgException & e) {
+    std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+  } catch (const std::runtime_error & e) {
+    std::cerr << "error: " << e.what() << std::endl;
+  }
+  return 1;
+}
@@ -0,0 +1,196 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Memory.h"
+#include "gtest/gtest.h"
+#include <Instructions.h>
+#include <Interface.h>
+#include <NativeCode.h>
+#include <Recompiler.h>
+#include <RomParser.h>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <register/RegisterManager.h>
+#include <sstream>
+
+const unsigned short int FREQ = 500;
+
+// Draws a sprite and calls a subroutine in a loop, polls the delay timer, then stores a BCD.
+const std::vector<uint8_t> PROGRAM = {
+        0x6A, 0x00, 0xA2, 0x40, 0xD0, 0x15, 0x22, 0x30, 0x7A, 0x01, 0x3A, 0x05, 0x12, 0x06,
+        0x6B, 0x10, 0xFB, 0x15, 0xFC, 0x07, 0x3C, 0x00, 0x12, 0x12, 0xA2, 0x50, 0xFA, 0x33,
+        0x12, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xA4, 0x81, 0xA5, 0x00, 0xEE, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x90, 0x90, 0x90, 0xF0};
+
+// Stores a BCD over its own code at 0x208, turning LD V1, 0x01 into SYS instructions.
+const std::vector<uint8_t> SELF_MODIFYING = {0xA2, 0x08, 0x60, 0xFF, 0xF0, 0x33, 0x00, 0x00,
+                                             0x61, 0x01, 0x62, 0x02, 0x12, 0x0C};
+
+// Loads I with an F000 whose operand is cut off by the end of the ROM.
+const std::vector<uint8_t> TRUNCATED_LOAD = {0x60, 0x01, 0xF0, 0x00};
+
+/**
+ * Writes the ROM and compiles it to a shared object with the compiler that built the tests.
+ * @returns Path of the shared object, empty if it could not be built.
+ */
+std::string build_native(const std::vector<uint8_t> & rom, const std::string & name) {
+  std::ofstream(name + ".ch8", std::ios_base::binary)
+          .write(reinterpret_cast<const char *>(rom.data()), rom.size());
+#if defined(CHIP8_TEST_CXX) && defined(CHIP8_TEST_INCLUDE)
+  std::ofstream source(name + ".cpp");
+  Recompiler(rom).emit(source, name + ".ch8");
+  source.close();
+
+  std::string command = std::string(CHIP8_TEST_CXX) + " -O1 -shared -fPIC -I" +
+                        CHIP8_TEST_INCLUDE + " " + name + ".cpp -o " + name + ".so";
+  if (std::system(command.c_str()) == 0) { return "./" + name + ".so"; }
+#endif
+  return "";
+}
+
+TEST(aot, control_flow_graph) {
+  // 0x200 skips over 0x202 to a call, the subroutine ends with an indirect jump
+  Recompiler recompiler({0x30, 0x00, 0x12, 0x0A, 0x22, 0x0C, 0x60, 0x01, 0x12, 0x08, 0x00, 0x00,
+                         0x61, 0x02, 0xB2, 0x00, 0x00, 0xE0});
+  std::map<mem::address_t, op::opcode_t> instructions = recompiler.get_instructions();
+
+  std::vector<mem::address_t> addresses;
+  for (const auto & instruction : instructions) { addresses.push_back(instruction.first); }
+  EXPECT_EQ(addresses, std::vector<mem::address_t>({0x200, 0x202, 0x204, 0x206, 0x208, 0x20A,
+                                                    0x20C, 0x20E}));
+  EXPECT_EQ(instructions[0x20E], 0xB200);
+
+  EXPECT_EQ(recompiler.get_successors(0x200, 0x3000),
+            std::vector<mem::address_t>({0x202, 0x204}));
+  EXPECT_EQ(recompiler.get_successors(0x204, 0x220C),
+            std::vector<mem::address_t>({0x20C, 0x206}));
+  EXPECT_TRUE(recompiler.get_successors(0x20E, 0xB200).empty());
+  EXPECT_TRUE(recompiler.get_successors(0x20E, 0x00EE).empty());
+}
+
+TEST(aot, emit) {
+  std::stringstream source;
+  Recompiler(PROGRAM).emit(source, "program.ch8");
+
+  char hash[32];
+  snprintf(hash, sizeof(hash), "0x%016llXULL",
+           static_cast<unsigned long long>(chip8_aot_hash(PROGRAM.data(), PROGRAM.size())));
+
+  EXPECT_NE(source.str().find(hash), std::string::npos);
+  EXPECT_NE(source.str().find("unsigned int chip8_aot_run("), std::string::npos);
+  EXPECT_NE(source.str().find("case 0x230:"), std::string::npos);
+  EXPECT_NE(source.str().find("s->exec(s, 0xD015)"), std::string::npos);
+  EXPECT_EQ(source.str().find("case 0x240:"), std::string::npos);
+}
+
+TEST(aot, same_as_interpreter) {
+  std::string native = build_native(PROGRAM, "aot_program");
+  if (native.empty()) { GTEST_SKIP() << "No compiler to build the native code"; }
+
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./aot_program.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<mem::Memory> memory2 = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<reg::RegisterManager> registers2 = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Interface> interface2 = std::make_shared<Interface>(registers2, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<Instructions> instructions2 =
+          std::make_shared<Instructions>(configuration, memory2, registers2, interface2);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+  std::shared_ptr<RomParser> romParser2 =
+          std::make_shared<RomParser>(configuration, memory2, registers2, instructions2);
+
+  romParser->load_native(native);
+  EXPECT_TRUE(romParser->is_native());
+
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(romParser->run(7), romParser2->run(7));
+    EXPECT_EQ(registers->pc_.peek(), registers2->pc_.peek());
+    EXPECT_EQ(registers->i_.peek(), registers2->i_.peek());
+    EXPECT_EQ(registers->dt_.peek(), registers2->dt_.peek());
+    EXPECT_EQ(registers->stack_.size(), registers2->stack_.size());
+    for (uint8_t v = 0; v <= 0xF; v++) {
+      EXPECT_EQ(registers->v_[v].peek(), registers2->v_[v].peek());
+    }
+  }
+  for (uint8_t y = 0; y < interface->display_->size_y(); y++) {
+    EXPECT_TRUE(interface->display_->get_row(y) == interface2->display_->get_row(y));
+  }
+  EXPECT_EQ(memory->peek(0x250), memory2->peek(0x250));
+  EXPECT_EQ(memory->peek(0x252), 0x5);
+  EXPECT_EQ(registers->pc_.peek(), 0x21C);
+  EXPECT_TRUE(romParser->is_native());
+  EXPECT_LT(romParser->get_fusion_stats().dispatches, romParser2->get_fusion_stats().dispatches);
+}
+
+TEST(aot, self_modifying_code) {
+  std::string native = build_native(SELF_MODIFYING, "aot_self_modifying");
+  if (native.empty()) { GTEST_SKIP() << "No compiler to build the native code"; }
+
+  std::shared_ptr<Configuration> configuration = std::make_shared<Configuration>(
+          "./aot_self_modifying.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  romParser->load_native(native);
+  romParser->run(20);
+
+  EXPECT_FALSE(romParser->is_native());
+  EXPECT_EQ(registers->v_[0x1].peek(), 0x0);
+  EXPECT_EQ(registers->v_[0x2].peek(), 0x0);
+  EXPECT_EQ(registers->pc_.peek(), 0x20C);
+}
+
+TEST(aot, truncated_long_load) {
+  std::string native = build_native(TRUNCATED_LOAD, "aot_truncated_load");
+  if (native.empty()) { GTEST_SKIP() << "No compiler to build the native code"; }
+
+  std::shared_ptr<Configuration> configuration = std::make_shared<Configuration>(
+          "./aot_truncated_load.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  romParser->load_native(native);
+  registers->i_.poke(0x123);
+  EXPECT_EQ(romParser->run(2), 2U);
+
+  // The interpreter runs the F000 from its own address, its operand being the memory after the ROM
+  EXPECT_EQ(registers->v_[0x0].peek(), 0x1);
+  EXPECT_EQ(registers->i_.peek(), 0x0);
+  EXPECT_EQ(registers->pc_.peek(), 0x206);
+}
+
+TEST(aot, other_rom) {
+  std::string native = build_native(PROGRAM, "aot_program");
+  if (native.empty()) { GTEST_SKIP() << "No compiler to build the native code"; }
+
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  EXPECT_THROW(romParser->load_native(native), std::runtime_error);
+  EXPECT_THROW(romParser->load_native("./missing.so"), std::runtime_error);
+  EXPECT_FALSE(romParser->is_native());
+}
@@ -0,0 +1,35 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Interface.h>
+#include <memory>
+#include <register/RegisterManager.h>
+
+const unsigned short int FREQ = 500;
+
+TEST(audio, buzzer) {
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+
+  interface->toogle_buzzer();
+  EXPECT_FALSE(interface->is_buzzing());
+
+  registers->st_.poke(0x2);
+  interface->toogle_buzzer();
+  EXPECT_TRUE(interface->is_buzzing());
+
+  registers->st_.poke(0x0);
+  interface->toogle_buzzer();
+  EXPECT_FALSE(interface->is_buzzing());
+}
+
+TEST(audio, device) {
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true, 48000, 256);
+
+  AudioStats stats = interface->get_audio_stats();
+  EXPECT_EQ(stats.underruns, 0);
+  EXPECT_EQ(stats.beeps, 0);
+  EXPECT_EQ(stats.mean_onset_latency, 0);
+}
@@ -0,0 +1,102 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Batch.h>
+#include <chip8.h>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+  // Draws the glyph of the lowest key held at (V1, 0), then moves right, forever. Key 0 exits.
+  const std::vector<uint8_t> ROM = {0xF0, 0x0A, 0x30, 0x00, 0x12, 0x08, 0x00, 0xFD, 0xF0, 0x29,
+                                    0xD1, 0x25, 0x71, 0x05, 0x12, 0x00};
+}// namespace
+
+TEST(batch, threads) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("", 500, false, false, false, false);
+  configuration->setSeed(1);
+  Batch single(configuration, ROM, 9, 1);
+  Batch pool(configuration, ROM, 9, 4);
+
+  std::vector<uint16_t> actions(9);
+  for (int step = 0; step < 20; step++) {
+    for (size_t index = 0; index < actions.size(); index++) {
+      actions[index] = (step + index) % 3 == 0 ? 0x0 : 0x1 << (1 + (step + index) % 15);
+    }
+    single.step(actions.data());
+    pool.step(actions.data());
+  }
+
+  EXPECT_EQ(memcmp(single.get_observations(), pool.get_observations(),
+                   9 * Batch::OBSERVATION_ROWS * sizeof(Display::row_t)),
+            0);
+  EXPECT_EQ(memcmp(single.get_status(), pool.get_status(), 9 * sizeof(Status)), 0);
+  EXPECT_EQ(memcmp(single.get_hashes(), pool.get_hashes(), 9 * sizeof(uint64_t)), 0);
+  EXPECT_FALSE(pool.get_observations()[0] == 0);
+}
+
+TEST(batch, shared_pages) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("", 500, false, false, false, false);
+  Batch batch(configuration, ROM, 20, 2);
+  for (size_t index = 0; index < batch.size(); index++) {
+    EXPECT_EQ(batch.get_machine(index).memory_->get_private_pages(), 0);
+    EXPECT_EQ(batch.get_machine(index).memory_->get_image()[0x2],
+              batch.get_machine(0).memory_->get_image()[0x2]);
+    EXPECT_EQ(batch.get_machine(index).memory_->peek(0x200), 0xF0);
+  }
+}
+
+TEST(batch, status_and_reset) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("", 500, false, false, false, false);
+  Batch batch(configuration, ROM, 3, 2);
+
+  // Instance 0 waits, 1 draws a 1, 2 exits
+  const uint16_t actions[] = {0x0, 0x2, 0x1};
+  batch.step(actions);
+  batch.step(actions);
+  EXPECT_EQ(batch.get_status()[0], Status::halted);
+  EXPECT_EQ(batch.get_status()[1], Status::running);
+  EXPECT_EQ(batch.get_status()[2], Status::exited);
+
+  const Display::row_t * observation = batch.get_observations() + Batch::OBSERVATION_ROWS;
+  EXPECT_TRUE(observation[0] == batch.get_machine(1).interface_->display_->get_row(0));
+  EXPECT_FALSE(observation[0] == 0);
+
+  batch.reset(1);
+  batch.reset(2);
+  EXPECT_TRUE(observation[0] == 0);
+  EXPECT_EQ(batch.get_status()[2], Status::running);
+  EXPECT_EQ(batch.get_machine(2).registers_->pc_.peek(), 0x200);
+}
+
+TEST(batch, capi) {
+  chip8_batch * batch = chip8_batch_create(4, 2, 500, 0, 1, ROM.data(), ROM.size());
+  ASSERT_NE(batch, nullptr);
+
+  const uint16_t actions[] = {0x1, 0x1, 0x2, 0x0};
+  chip8_batch_step(batch, actions);
+  chip8_batch_step(batch, actions);
+  const uint8_t * status = chip8_batch_get_status(batch);
+  EXPECT_EQ(status[0], CHIP8_EXITED);
+  EXPECT_EQ(status[2], CHIP8_RUNNING);
+  EXPECT_EQ(status[3], CHIP8_HALTED);
+
+  // The random numbers aside, instances 0 and 1 went through the same states
+  const uint64_t * hashes = chip8_batch_get_hashes(batch);
+  EXPECT_EQ(hashes[0], hashes[1]);
+  EXPECT_NE(hashes[0], hashes[2]);
+  EXPECT_NE(hashes[2], hashes[3]);
+
+  const uint8_t * observations = chip8_batch_get_observations(batch);
+  Display::row_t row;
+  memcpy(&row, observations + 2 * Batch::OBSERVATION_ROWS * CHIP8_ROW_BYTES, CHIP8_ROW_BYTES);
+  EXPECT_FALSE(row == 0);
+
+  chip8_batch_destroy(batch);
+  EXPECT_EQ(chip8_batch_create(0, 1, 500, 0, 1, ROM.data(), ROM.size()), nullptr);
+}
@@ -0,0 +1,78 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Display.h>
+#include <Memory.h>
+#include <chip8.h>
+#include <cstring>
+#include <vector>
+
+TEST(capi, run) {
+  ASSERT_EQ(chip8_get_api_version(), CHIP8_API_VERSION);
+  chip8 * machine = chip8_create(500, 0, 1);
+  ASSERT_NE(machine, nullptr);
+
+  // Waits for key 0, draws the 0 glyph at (0, 0), then exits.
+  const uint8_t rom[] = {0xE0, 0x9E, 0x12, 0x00, 0xF0, 0x29, 0xD0, 0x05, 0x00, 0xFD};
+  ASSERT_EQ(chip8_load_rom(machine, rom, sizeof(rom)), 0);
+  uint64_t loaded = chip8_get_state_hash(machine);
+  EXPECT_EQ(chip8_get_width(machine), 64);
+  EXPECT_EQ(chip8_get_height(machine), 32);
+
+  const uint8_t * plane = chip8_get_plane(machine, 0);
+  ASSERT_NE(plane, nullptr);
+  EXPECT_EQ(chip8_get_plane(machine, chip8_get_planes(machine)), nullptr);
+
+  EXPECT_GT(chip8_run_frame(machine), 0);
+  EXPECT_EQ(chip8_get_status(machine), CHIP8_RUNNING);
+  Display::row_t row;
+  memcpy(&row, plane, CHIP8_ROW_BYTES);
+  EXPECT_TRUE(row == 0);
+
+  chip8_set_keys(machine, 0x1);
+  chip8_run_cycles(machine, 10);
+  EXPECT_EQ(chip8_get_status(machine), CHIP8_EXITED);
+  EXPECT_EQ(chip8_get_fault(machine), nullptr);
+
+  // The pointer sees the frame buffer in place: the glyph's first row is 0xF0
+  memcpy(&row, plane, CHIP8_ROW_BYTES);
+  EXPECT_TRUE(row == static_cast<Display::row_t>(0xF0) << 120);
+
+  // Reloading starts over from an empty machine
+  ASSERT_EQ(chip8_load_rom(machine, rom, sizeof(rom)), 0);
+  EXPECT_EQ(chip8_get_status(machine), CHIP8_RUNNING);
+  memcpy(&row, plane, CHIP8_ROW_BYTES);
+  EXPECT_TRUE(row == 0);
+  EXPECT_EQ(chip8_get_state_hash(machine), loaded);
+
+  chip8_destroy(machine);
+}
+
+TEST(capi, errors) {
+  // The timers would never tick, or the frequency would wrap around
+  EXPECT_EQ(chip8_create(0, 0, 0), nullptr);
+  EXPECT_EQ(chip8_create(CHIP8_MIN_FREQUENCY - 1, 0, 0), nullptr);
+  EXPECT_EQ(chip8_create(CHIP8_MAX_FREQUENCY + 1, 0, 0), nullptr);
+  const uint8_t empty[] = {0x12, 0x00};
+  EXPECT_EQ(chip8_batch_create(2, 1, CHIP8_MAX_FREQUENCY + 1, 0, 0, empty, sizeof(empty)),
+            nullptr);
+  chip8 * fastest = chip8_create(CHIP8_MAX_FREQUENCY, 0, 0);
+  EXPECT_NE(fastest, nullptr);
+  chip8_destroy(fastest);
+
+  chip8 * machine = chip8_create(500, CHIP8_QUIRK_LOGIC_RESETS_VF, 0);
+  ASSERT_NE(machine, nullptr);
+
+  std::vector<uint8_t> rom(mem::MEMORY_SIZE - 0x200 + 1, 0x0);
+  EXPECT_EQ(chip8_load_rom(machine, rom.data(), rom.size()), -1);
+
+  // Unknown opcode
+  rom = {0xFF, 0xFF};
+  ASSERT_EQ(chip8_load_rom(machine, rom.data(), rom.size()), 0);
+  chip8_run_frame(machine);
+  EXPECT_EQ(chip8_get_status(machine), CHIP8_FAULTED);
+  EXPECT_STREQ(chip8_get_fault(machine), "unknown opcode");
+
+  chip8_destroy(machine);
+}
@@ -0,0 +1,230 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Memory.h"
+#include "gtest/gtest.h"
+#include <Display.h>
+#include <Instructions.h>
+#include <Interface.h>
+#include <RomParser.h>
+#include <memory>
+#include <register/RegisterManager.h>
+
+const unsigned short int FREQ = 500;
+
+TEST(display, resolution) {
+  std::shared_ptr<Display> display = std::make_shared<Display>();
+
+  EXPECT_FALSE(display->is_hires());
+  EXPECT_EQ(display->size_x(), 64);
+  EXPECT_EQ(display->size_y(), 32);
+  EXPECT_THROW(display->is_pixel_on(64, 0), std::runtime_error);
+
+  display->set_pixel_state(3, 3, true);
+  display->set_hires(true);
+
+  EXPECT_EQ(display->size_x(), 128);
+  EXPECT_EQ(display->size_y(), 64);
+  EXPECT_FALSE(display->is_pixel_on(3, 3));
+  EXPECT_NO_THROW(display->is_pixel_on(127, 63));
+}
+
+TEST(display, sprite_wraps) {
+  std::shared_ptr<Display> display = std::make_shared<Display>();
+  display->set_hires(true);
+
+  uint16_t sprite[] = {0xF00F, 0x8001};
+  EXPECT_FALSE(display->draw_sprite(124, 63, sprite, 2, 16));
+
+  for (int x = 0; x < 128; x++) {
+    bool row0 = x >= 124 || (x >= 8 && x < 12);
+    bool row1 = x == 124 || x == 11;
+    EXPECT_EQ(display->is_pixel_on(x, 63), row0);
+    EXPECT_EQ(display->is_pixel_on(x, 0), row1);
+  }
+
+  EXPECT_TRUE(display->draw_sprite(124, 63, sprite, 2, 16));
+  for (int x = 0; x < 128; x++) {
+    EXPECT_FALSE(display->is_pixel_on(x, 63));
+    EXPECT_FALSE(display->is_pixel_on(x, 0));
+  }
+}
+
+TEST(display, scroll) {
+  std::shared_ptr<Display> display = std::make_shared<Display>();
+
+  display->set_pixel_state(0, 0, true);
+  display->set_pixel_state(62, 31, true);
+
+  display->scroll_down(1);
+  EXPECT_TRUE(display->is_pixel_on(0, 1));
+  EXPECT_FALSE(display->is_pixel_on(0, 0));
+  EXPECT_FALSE(display->is_pixel_on(62, 31));
+
+  display->scroll_right(4);
+  EXPECT_TRUE(display->is_pixel_on(4, 1));
+  EXPECT_FALSE(display->is_pixel_on(0, 1));
+
+  display->scroll_left(4);
+  display->scroll_left(4);
+  for (int x = 0; x < 64; x++) {
+    for (int y = 0; y < 32; y++) { EXPECT_FALSE(display->is_pixel_on(x, y)); }
+  }
+}
+
+TEST(display, 00Cn_00FB_00FC) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  interface->display_->set_hires(true);
+  interface->display_->set_pixel_state(100, 10, true);
+
+  romParser->set_opcode(0x00C5);
+  romParser->decode();
+  EXPECT_TRUE(interface->display_->is_pixel_on(100, 15));
+
+  romParser->set_opcode(0x00FB);
+  romParser->decode();
+  EXPECT_TRUE(interface->display_->is_pixel_on(104, 15));
+
+  romParser->set_opcode(0x00FC);
+  romParser->decode();
+  romParser->decode();
+  EXPECT_TRUE(interface->display_->is_pixel_on(96, 15));
+  EXPECT_FALSE(interface->display_->is_pixel_on(104, 15));
+}
+
+TEST(display, 00FD_00FE_00FF) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  romParser->set_opcode(0x00FF);
+  romParser->decode();
+  EXPECT_TRUE(interface->display_->is_hires());
+
+  romParser->set_opcode(0x00FE);
+  romParser->decode();
+  EXPECT_FALSE(interface->display_->is_hires());
+
+  memory->poke({0x00, 0xFD, 0x12, 0x00}, 0x200);
+  EXPECT_EQ(romParser->run(FREQ), 1);
+  EXPECT_TRUE(registers->exited_);
+}
+
+TEST(display, Dxy0) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  // 16x16 sprite with only its corners lit
+  memory->poke(std::vector<uint8_t>(32, 0x0), 0x300);
+  memory->poke({0x80, 0x01}, 0x300);
+  memory->poke({0x80, 0x01}, 0x31E);
+  registers->i_.poke(0x300);
+  registers->v_[0x1].poke(10);
+  registers->v_[0x2].poke(20);
+
+  romParser->set_opcode(0x00FF);
+  romParser->decode();
+  romParser->set_opcode(0xD120);
+  romParser->decode();
+
+  EXPECT_TRUE(interface->display_->is_pixel_on(10, 20));
+  EXPECT_TRUE(interface->display_->is_pixel_on(25, 20));
+  EXPECT_TRUE(interface->display_->is_pixel_on(10, 35));
+  EXPECT_TRUE(interface->display_->is_pixel_on(25, 35));
+  EXPECT_FALSE(interface->display_->is_pixel_on(11, 21));
+  EXPECT_EQ(registers->v_[0xf].peek(), 0x0);
+
+  romParser->decode();
+  EXPECT_FALSE(interface->display_->is_pixel_on(10, 20));
+  EXPECT_EQ(registers->v_[0xf].peek(), 0x1);
+}
+
+TEST(display, Fx30) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  for (uint8_t i = 0; i <= 0xf; i++) {
+    registers->v_[0x3].poke(i);
+    romParser->set_opcode(0xF330);
+    romParser->decode();
+    EXPECT_EQ(registers->i_.peek(), memory->FONT_.size() + i * 10);
+    EXPECT_EQ(memory->peek(registers->i_.peek()), memory->BIG_FONT_[i * 10]);
+  }
+}
+
+TEST(display, Fx75_Fx85) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  for (uint8_t i = 0; i <= 0xF; i++) { registers->v_[i].poke(i + 1); }
+
+  romParser->set_opcode(0xF775);
+  romParser->decode();
+
+  for (uint8_t i = 0; i <= 0xF; i++) { registers->v_[i].poke(0x0); }
+
+  romParser->set_opcode(0xF685);
+  romParser->decode();
+
+  for (uint8_t i = 0; i <= 0x6; i++) { EXPECT_EQ(registers->v_[i].peek(), i + 1); }
+  EXPECT_EQ(registers->v_[0x7].peek(), 0x0);
+}
+
+TEST(display, render_request) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  EXPECT_FALSE(interface->take_render_request());
+
+  romParser->set_opcode(0xD015);
+  romParser->decode();
+  EXPECT_TRUE(interface->take_render_request());
+  EXPECT_FALSE(interface->take_render_request());
+
+  romParser->set_opcode(0x00E0);
+  romParser->decode();
+  EXPECT_TRUE(interface->take_render_request());
+}
@@ -0,0 +1,82 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Explorer.h>
+#include <QuirkDatabase.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+  /**
+   * Faults on key 5, hangs on key 3, waits for another key otherwise.
+   */
+  const std::vector<uint8_t> ROM = {
+          0xF0, 0x0A,// LD V0, K
+          0x30, 0x05,// SE V0, 5
+          0x12, 0x08,// JP 0x208
+          0x00, 0xEE,// RET: stack underflow
+          0x30, 0x03,// SE V0, 3
+          0x12, 0x00,// JP 0x200
+          0x12, 0x0C,// JP 0x20C
+  };
+
+  const Finding * find(const Explorer & explorer, FindingKind kind) {
+    const std::vector<Finding> & findings = explorer.get_findings();
+    auto found = std::find_if(findings.begin(), findings.end(),
+                              [&](const Finding & finding) { return finding.kind == kind; });
+    return found == findings.end() ? nullptr : &*found;
+  }
+}// namespace
+
+TEST(explorer, findings) {
+  Explorer explorer(quirk::make_configuration("", 500, 0x0), ROM, 4);
+  while (explorer.get_stats().depth < 10 && explorer.expand()) {}
+  // Every state reached was expanded
+  EXPECT_LT(explorer.get_stats().depth, 10);
+  EXPECT_EQ(explorer.get_stats().frontier, 0);
+
+  const Finding * fault = find(explorer, FindingKind::fault);
+  ASSERT_NE(fault, nullptr);
+  EXPECT_EQ(fault->fault, Fault::stack_underflow);
+  EXPECT_EQ(fault->pc, 0x206);
+  EXPECT_EQ(fault->inputs, std::vector<uint16_t>{0x1 << 0x5});
+
+  const Finding * hang = find(explorer, FindingKind::hang);
+  ASSERT_NE(hang, nullptr);
+  EXPECT_EQ(hang->pc, 0x20C);
+  EXPECT_EQ(hang->inputs, std::vector<uint16_t>{0x1 << 0x3});
+  EXPECT_EQ(find(explorer, FindingKind::exit), nullptr);
+
+  for (mem::address_t address = 0x200; address < 0x200 + ROM.size(); address += 2) {
+    EXPECT_TRUE(explorer.is_covered(address)) << address;
+  }
+  EXPECT_FALSE(explorer.is_covered(0x20E));
+  EXPECT_EQ(explorer.get_stats().unique_pcs, ROM.size() / 2);
+}
+
+TEST(explorer, threads) {
+  Explorer parallel(quirk::make_configuration("", 500, 0x0), ROM, 4);
+  Explorer serial(quirk::make_configuration("", 500, 0x0), ROM, 1);
+  for (unsigned int depth = 0; depth < 3; depth++) {
+    parallel.expand();
+    serial.expand();
+    EXPECT_EQ(parallel.get_stats().states, serial.get_stats().states);
+    EXPECT_EQ(parallel.get_stats().frontier, serial.get_stats().frontier);
+  }
+  ASSERT_EQ(parallel.get_findings().size(), serial.get_findings().size());
+  for (size_t i = 0; i < serial.get_findings().size(); i++) {
+    EXPECT_EQ(parallel.get_findings()[i].kind, serial.get_findings()[i].kind);
+    EXPECT_EQ(parallel.get_findings()[i].inputs, serial.get_findings()[i].inputs);
+  }
+}
+
+TEST(explorer, beam) {
+  Explorer explorer(quirk::make_configuration("", 500, 0x0), ROM, 2, 3);
+  explorer.expand();
+  EXPECT_EQ(explorer.get_stats().frontier, 3);
+  // The states are counted before the beam keeps the best ones
+  EXPECT_GT(explorer.get_stats().states, 4);
+  EXPECT_THROW(Explorer(quirk::make_configuration("", 500, 0x0), ROM, 0),
+               std::runtime_error);
+}
@@ -0,0 +1,105 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <FrameExport.h>
+#include <QuirkDatabase.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+  // One object per test process, so parallel test runs do not share it
+  std::string get_name(const std::string & test) {
+    return "/chip8_test_" + test + "_" + std::to_string(getpid());
+  }
+}// namespace
+
+TEST(export, publish) {
+  const std::string name = get_name("publish");
+  EXPECT_THROW(FrameExportReader{name}, std::runtime_error);
+
+  FrameExport exporter(name);
+  FrameExportReader reader(name);
+  ExportedFrame frame{};
+  EXPECT_FALSE(reader.read(frame));
+  EXPECT_EQ(reader.get_published(), 0);
+
+  Machine machine(quirk::make_configuration("", 500, 0x0), false);
+  machine.registers_->pc_.poke(0x234);
+  machine.registers_->dt_.poke(0x12);
+  machine.registers_->halted_ = true;
+  machine.interface_->keypad_->set_mask(0x8001);
+  machine.interface_->display_->set_pixel_state(3, 4, true);
+  exporter.publish(machine, {100, 2, 0, 1, 0, 0.0});
+
+  ASSERT_TRUE(reader.read(frame));
+  EXPECT_EQ(reader.get_published(), 1);
+  EXPECT_EQ(frame.frame, 100);
+  EXPECT_EQ(frame.late, 2);
+  EXPECT_EQ(frame.skipped, 1);
+  EXPECT_EQ(frame.pc, 0x234);
+  EXPECT_EQ(frame.dt, 0x12);
+  EXPECT_EQ(frame.keys, 0x8001);
+  EXPECT_EQ(frame.width, 64);
+  EXPECT_EQ(frame.height, 32);
+  EXPECT_EQ(frame.flags, ExportedFrame::FLAG_HALTED);
+  EXPECT_EQ(frame.pixels[4][3], 0x1);
+  EXPECT_EQ(frame.pixels[4][2], 0x0);
+  EXPECT_EQ(frame.pixels[3][3], 0x0);
+
+  // The pixels follow the frame buffer
+  machine.interface_->display_->set_pixel_state(3, 4, false);
+  machine.interface_->display_->set_hires(true);
+  machine.interface_->display_->set_pixel_state(127, 63, true);
+  exporter.publish(machine);
+  ASSERT_TRUE(reader.read(frame));
+  EXPECT_EQ(exporter.get_published(), 2);
+  EXPECT_EQ(frame.frame, 0);
+  EXPECT_EQ(frame.width, 128);
+  EXPECT_EQ(frame.flags, ExportedFrame::FLAG_HALTED | ExportedFrame::FLAG_HIRES);
+  EXPECT_EQ(frame.pixels[4][3], 0x0);
+  EXPECT_EQ(frame.pixels[63][127], 0x1);
+}
+
+TEST(export, concurrent) {
+  const std::string name = get_name("concurrent");
+  FrameExport exporter(name);
+  FrameExportReader reader(name);
+  Machine machine(quirk::make_configuration("", 500, 0x0), false);
+  const unsigned long frames = 2000;
+
+  // Even frames are blank, odd frames have every pixel on: a torn read mixes both
+  std::atomic<bool> done{false};
+  std::thread writer([&]() {
+    Display & display = *machine.interface_->display_;
+    for (unsigned long i = 1; i <= frames; i++) {
+      for (unsigned short int y = 0; y < display.size_y(); y++) {
+        for (unsigned short int x = 0; x < display.size_x(); x++) {
+          display.set_pixel_state(x, y, i & 0x1);
+        }
+      }
+      exporter.publish(machine, {i, 0, 0, 0, 0, 0.0});
+    }
+    done = true;
+  });
+
+  ExportedFrame frame{};
+  unsigned long read = 0;
+  while (!done || read == 0) {
+    if (!reader.read(frame)) { continue; }
+    read++;
+    uint8_t expected = frame.frame & 0x1;
+    for (unsigned short int y = 0; y < frame.height; y++) {
+      for (unsigned short int x = 0; x < frame.width; x++) {
+        ASSERT_EQ(frame.pixels[y][x], expected) << frame.frame;
+      }
+    }
+  }
+  writer.join();
+
+  ASSERT_TRUE(reader.read(frame));
+  EXPECT_EQ(frame.frame, frames);
+  EXPECT_EQ(reader.get_published(), frames);
+}
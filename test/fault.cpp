@@ -0,0 +1,138 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Memory.h"
+#include "gtest/gtest.h"
+#include <Instructions.h>
+#include <Interface.h>
+#include <RomParser.h>
+#include <memory>
+#include <register/RegisterManager.h>
+
+const unsigned short int FREQ = 500;
+
+// Counts in V1, hits an unknown opcode, then counts in V2.
+const std::vector<uint8_t> PROGRAM = {0x71, 0x01, 0x80, 0x0F, 0x72, 0x01, 0x12, 0x00};
+
+TEST(fault, halt) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  memory->poke(PROGRAM, 0x200);
+
+  EXPECT_EQ(romParser->run(100), 2);
+  EXPECT_TRUE(registers->faulted_);
+  EXPECT_EQ(registers->fault_, Fault::unknown_opcode);
+  EXPECT_EQ(registers->fault_address_, 0x202);
+  EXPECT_EQ(registers->faults_, 1);
+  EXPECT_EQ(registers->pc_.peek(), 0x204);
+
+  // Stays halted until the fault is cleared
+  EXPECT_EQ(romParser->run(100), 0);
+  EXPECT_EQ(registers->v_[0x2].peek(), 0x0);
+
+  registers->faulted_ = false;
+  EXPECT_EQ(romParser->run(3), 3);
+  EXPECT_EQ(registers->v_[0x1].peek(), 0x2);
+  EXPECT_EQ(registers->v_[0x2].peek(), 0x1);
+}
+
+TEST(fault, ignore) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  configuration->setFaultPolicy(FaultPolicy::ignore);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  memory->poke(PROGRAM, 0x200);
+
+  EXPECT_EQ(romParser->run(40), 40);
+  EXPECT_FALSE(registers->faulted_);
+  EXPECT_EQ(registers->fault_, Fault::unknown_opcode);
+  EXPECT_EQ(registers->faults_, 10);
+  EXPECT_EQ(registers->v_[0x1].peek(), 10);
+  EXPECT_EQ(registers->v_[0x2].peek(), 10);
+}
+
+TEST(fault, out_of_range) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  // The access is checked as a whole, nothing is written
+  registers->i_.poke(mem::MEMORY_SIZE - 2);
+  registers->v_[0x0].poke(123);
+  romParser->set_opcode(0xF033);
+  EXPECT_EQ(romParser->decode(), Fault::address_out_of_range);
+  EXPECT_EQ(memory->peek(mem::MEMORY_SIZE - 2), 0x0);
+  EXPECT_EQ(memory->peek(mem::MEMORY_SIZE - 1), 0x0);
+
+  registers->faulted_ = false;
+  romParser->set_opcode(0xF155);
+  EXPECT_EQ(romParser->decode(), Fault::none);
+  EXPECT_EQ(memory->peek(mem::MEMORY_SIZE - 2), 123);
+  romParser->set_opcode(0xF265);
+  EXPECT_EQ(romParser->decode(), Fault::address_out_of_range);
+
+  registers->faulted_ = false;
+  romParser->set_opcode(0xD015);
+  EXPECT_EQ(romParser->decode(), Fault::address_out_of_range);
+  EXPECT_TRUE(interface->display_->get_row(0) == 0);
+
+  // Fetch past the end of the memory
+  registers->faulted_ = false;
+  registers->pc_.poke(mem::MEMORY_SIZE - 1);
+  EXPECT_EQ(romParser->step(), Fault::address_out_of_range);
+  registers->faulted_ = false;
+  EXPECT_EQ(romParser->run(10), 1);
+  EXPECT_EQ(registers->fault_address_, mem::MEMORY_SIZE - 1);
+}
+
+TEST(fault, decode_address) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  registers->pc_.poke(0x302);
+  romParser->set_opcode(0x800F);
+  EXPECT_EQ(romParser->decode(), Fault::unknown_opcode);
+  EXPECT_EQ(registers->fault_address_, 0x300);
+
+  // The fault is not cleared, the next instruction still runs normally
+  romParser->set_opcode(0x7101);
+  EXPECT_EQ(romParser->decode(), Fault::none);
+  EXPECT_TRUE(registers->faulted_);
+  EXPECT_EQ(registers->fault_address_, 0x300);
+
+  // Without run()
+  registers->faulted_ = false;
+  memory->poke({0x00, 0xEE}, 0x240);
+  registers->pc_.poke(0x240);
+  EXPECT_EQ(romParser->step(), Fault::none);
+  EXPECT_EQ(romParser->decode(), Fault::stack_underflow);
+  EXPECT_EQ(registers->fault_address_, 0x240);
+}
@@ -0,0 +1,127 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Lockstep.h>
+#include <Machine.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST(fingerprint, memory) {
+  std::mt19937 random(3);
+  mem::Memory memory;
+  mem::Memory copy;
+  uint64_t empty = memory.get_hash();
+  EXPECT_EQ(copy.get_hash(), empty);
+
+  // Writing a byte back restores the fingerprint
+  memory.poke(0x42, 0x300);
+  EXPECT_NE(memory.get_hash(), empty);
+  memory.poke(0x00, 0x300);
+  EXPECT_EQ(memory.get_hash(), empty);
+
+  // The same value at another address changes it
+  memory.poke(0x42, 0x300);
+  copy.poke(0x42, 0x301);
+  EXPECT_NE(memory.get_hash(), copy.get_hash());
+
+  for (int write = 0; write < 2000; write++) {
+    memory.poke(random() & 0xFF, random() % mem::MEMORY_SIZE);
+    if (write % 500 == 0) { copy.set_image(memory.get_image()); }
+  }
+
+  // Same contents written in another order
+  mem::Memory rebuilt;
+  for (unsigned int address = mem::MEMORY_SIZE; address-- > 0;) {
+    rebuilt.poke(memory.peek(address), address);
+  }
+  EXPECT_EQ(rebuilt.get_hash(), memory.get_hash());
+  copy.set_image(memory.get_image());
+  EXPECT_EQ(copy.get_hash(), memory.get_hash());
+}
+
+TEST(fingerprint, display) {
+  std::mt19937 random(5);
+  Display display;
+  uint64_t empty = display.get_hash();
+
+  display.set_pixel_state(3, 4, true);
+  EXPECT_NE(display.get_hash(), empty);
+  display.set_pixel_state(3, 4, false);
+  EXPECT_EQ(display.get_hash(), empty);
+
+  display.set_hires(true);
+  const uint16_t rows[16 * Display::PLANES] = {0xFFFF, 0x8001, 0x1234, 0xF00F, 0x0FF0};
+  for (int operation = 0; operation < 200; operation++) {
+    display.select_planes(random() & 0xF);
+    switch (random() % 8) {
+      case 0:
+        display.scroll_down(random() % 8);
+        break;
+      case 1:
+        display.scroll_up(random() % 8);
+        break;
+      case 2:
+        display.scroll_left(4);
+        break;
+      case 3:
+        display.scroll_right(4);
+        break;
+      default:
+        display.draw_sprite(random(), random(), rows, 5, 16);
+    }
+  }
+
+  // The same pixels set one by one
+  Display rebuilt;
+  rebuilt.set_hires(true);
+  for (uint8_t plane = 0; plane < Display::PLANES; plane++) {
+    rebuilt.select_planes(0x1 << plane);
+    for (int y = 0; y < display.size_y(); y++) {
+      for (int x = 0; x < display.size_x(); x++) {
+        rebuilt.set_pixel_state(x, y, (display.get_color(x, y) >> plane) & 0x1);
+      }
+    }
+  }
+  rebuilt.select_planes(display.get_planes());
+  EXPECT_EQ(rebuilt.get_hash(), display.get_hash());
+
+  rebuilt.select_planes(~display.get_planes());
+  EXPECT_NE(rebuilt.get_hash(), display.get_hash());
+}
+
+TEST(fingerprint, machine) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("", 500, false, false, false, false);
+  configuration->setSeed(9);
+  Machine machine(configuration, false);
+
+  // Counts V0 up to 3 with a delay, stores it, draws it, then starts over: states repeat.
+  machine.romParser_->load({0x60, 0x00, 0x61, 0x02, 0xF1, 0x15, 0xF1, 0x07, 0x31, 0x00, 0x12,
+                            0x06, 0x70, 0x01, 0xA3, 0x00, 0xF0, 0x55, 0xF0, 0x29, 0xD2, 0x25,
+                            0xD2, 0x25, 0x30, 0x03, 0x12, 0x02, 0x12, 0x00});
+
+  // A fingerprint matches another one exactly when the captured states match
+  std::vector<MachineState> states;
+  std::vector<uint64_t> hashes;
+  for (int frame = 0; frame < 60; frame++) {
+    machine.romParser_->run(std::max<unsigned int>(machine.registers_->cycles_to_next_tick(), 1));
+    states.push_back(MachineState::capture(machine));
+    hashes.push_back(machine.get_hash());
+  }
+  unsigned int repeats = 0;
+  for (size_t a = 0; a < states.size(); a++) {
+    for (size_t b = a + 1; b < states.size(); b++) {
+      bool same = states[a].diff(states[b]).empty();
+      EXPECT_EQ(hashes[a] == hashes[b], same) << a << " " << b;
+      repeats += same;
+    }
+  }
+  EXPECT_GT(repeats, 0);
+
+  // The keys are part of the state
+  uint64_t hash = machine.get_hash();
+  machine.interface_->keypad_->press(0x7);
+  EXPECT_NE(machine.get_hash(), hash);
+}
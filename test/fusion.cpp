@@ -0,0 +1,156 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Memory.h"
+#include "gtest/gtest.h"
+#include <Instructions.h>
+#include <Interface.h>
+#include <RomParser.h>
+#include <memory>
+#include <register/RegisterManager.h>
+
+const unsigned short int FREQ = 500;
+
+// Draws a sprite, then runs a 7xkk / 3xkk loop, a delay timer poll and a 7xkk / 4xkk loop.
+const std::vector<uint8_t> PROGRAM = {
+        0xA2, 0x20, 0xD0, 0x15, 0x62, 0x05, 0xF2, 0x15, 0x73, 0x01, 0x33, 0x04, 0x12, 0x08,
+        0xF4, 0x07, 0x34, 0x00, 0x12, 0x0E, 0x75, 0x01, 0x45, 0x03, 0x12, 0x1C, 0x12, 0x14,
+        0x12, 0x1C, 0x00, 0x00, 0xF0, 0x90, 0x90, 0x90, 0xF0};
+
+TEST(fusion, pairs) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  memory->poke(PROGRAM, 0x200);
+
+  // Annn Dxyn
+  romParser->step();
+  EXPECT_EQ(romParser->fuse(0xFFFF), 1);
+  EXPECT_EQ(registers->i_.peek(), 0x220);
+  EXPECT_TRUE(interface->display_->is_pixel_on(0, 0));
+  EXPECT_EQ(registers->pc_.peek(), 0x204);
+  EXPECT_EQ(registers->cycles_to_next_tick(), FREQ / 60 - 1);
+
+  // 6xkk Fx15
+  romParser->step();
+  EXPECT_EQ(romParser->fuse(0xFFFF), 1);
+  EXPECT_EQ(registers->v_[0x2].peek(), 0x5);
+  EXPECT_EQ(registers->dt_.peek(), 0x5);
+  EXPECT_EQ(registers->pc_.peek(), 0x208);
+
+  // 7xkk 3xkk, not skipping then skipping
+  romParser->step();
+  EXPECT_EQ(romParser->fuse(0xFFFF), 1);
+  EXPECT_EQ(registers->pc_.peek(), 0x20C);
+  registers->v_[0x3].poke(0x3);
+  registers->pc_.poke(0x208);
+  romParser->step();
+  EXPECT_EQ(romParser->fuse(0xFFFF), 1);
+  EXPECT_EQ(registers->pc_.peek(), 0x20E);
+
+  // Not fused without a spare cycle
+  registers->pc_.poke(0x214);
+  romParser->step();
+  EXPECT_EQ(romParser->fuse(0), 0);
+
+  // 7xkk 4xkk
+  registers->pc_.poke(0x214);
+  romParser->step();
+  EXPECT_EQ(romParser->fuse(0xFFFF), 1);
+  EXPECT_EQ(registers->v_[0x5].peek(), 0x1);
+  EXPECT_EQ(registers->pc_.peek(), 0x21A);
+
+  const FusionStats & stats = romParser->get_fusion_stats();
+  EXPECT_EQ(stats.fused[static_cast<size_t>(op::Fusion::ld_drw_Annn_Dxyn)], 1);
+  EXPECT_EQ(stats.fused[static_cast<size_t>(op::Fusion::ld_ld_6xkk_Fx15)], 1);
+  EXPECT_EQ(stats.fused[static_cast<size_t>(op::Fusion::add_se_7xkk_3xkk)], 2);
+  EXPECT_EQ(stats.fused[static_cast<size_t>(op::Fusion::add_sne_7xkk_4xkk)], 1);
+}
+
+TEST(fusion, delay_timer_poll) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  memory->poke(PROGRAM, 0x200);
+  registers->dt_.poke(0x1);
+
+  // Loops back to Fx07
+  registers->pc_.poke(0x20E);
+  romParser->step();
+  EXPECT_EQ(romParser->fuse(0xFFFF), 2);
+  EXPECT_EQ(registers->v_[0x4].peek(), 0x1);
+  EXPECT_EQ(registers->pc_.peek(), 0x20E);
+
+  // Would straddle a timer tick
+  registers->skip_cycles(registers->cycles_to_next_tick() - 2);
+  romParser->step();
+  EXPECT_EQ(romParser->fuse(0xFFFF), 0);
+
+  // Leaves the loop, once the timers ticked
+  registers->dt_.poke(0x0);
+  registers->pc_.poke(0x20E);
+  registers->trigger_timers();
+  registers->trigger_timers();
+  romParser->step();
+  EXPECT_EQ(romParser->fuse(0xFFFF), 1);
+  EXPECT_EQ(registers->pc_.peek(), 0x214);
+}
+
+TEST(fusion, same_as_decode) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<Configuration> unfused =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  unfused->setFusion(false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<mem::Memory> memory2 = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<reg::RegisterManager> registers2 = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Interface> interface2 = std::make_shared<Interface>(registers2, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<Instructions> instructions2 =
+          std::make_shared<Instructions>(unfused, memory2, registers2, interface2);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+  std::shared_ptr<RomParser> romParser2 =
+          std::make_shared<RomParser>(unfused, memory2, registers2, instructions2);
+
+  memory->poke(PROGRAM, 0x200);
+  memory2->poke(PROGRAM, 0x200);
+
+  // Budgets that are not a multiple of the sequences, so some are split between two calls
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(romParser->run(7), romParser2->run(7));
+    EXPECT_EQ(registers->pc_.peek(), registers2->pc_.peek());
+    EXPECT_EQ(registers->i_.peek(), registers2->i_.peek());
+    EXPECT_EQ(registers->dt_.peek(), registers2->dt_.peek());
+    EXPECT_EQ(registers->cycles_to_next_tick(), registers2->cycles_to_next_tick());
+    for (uint8_t v = 0; v <= 0xF; v++) {
+      EXPECT_EQ(registers->v_[v].peek(), registers2->v_[v].peek());
+    }
+  }
+  for (uint8_t y = 0; y < interface->display_->size_y(); y++) {
+    EXPECT_TRUE(interface->display_->get_row(y) == interface2->display_->get_row(y));
+  }
+
+  const FusionStats & stats = romParser->get_fusion_stats();
+  EXPECT_EQ(stats.instructions, romParser2->get_fusion_stats().instructions);
+  EXPECT_LT(stats.dispatches, romParser2->get_fusion_stats().dispatches);
+  EXPECT_EQ(registers->pc_.peek(), 0x21C);
+}
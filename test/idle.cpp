@@ -0,0 +1,186 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Memory.h"
+#include "gtest/gtest.h"
+#include <Instructions.h>
+#include <Interface.h>
+#include <RomParser.h>
+#include <memory>
+#include <register/RegisterManager.h>
+
+const unsigned short int FREQ = 500;
+
+TEST(idle, cycles_to_next_tick) {
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  registers->dt_.poke(0x2);
+
+  EXPECT_EQ(registers->cycles_to_next_tick(), FREQ / 60);
+
+  registers->trigger_timers();
+  EXPECT_EQ(registers->cycles_to_next_tick(), FREQ / 60 - 1);
+
+  registers->skip_cycles(FREQ / 60 - 2);
+  EXPECT_EQ(registers->cycles_to_next_tick(), 1);
+  EXPECT_EQ(registers->dt_.peek(), 0x2);
+  EXPECT_THROW(registers->skip_cycles(1), std::runtime_error);
+
+  registers->trigger_timers();
+  EXPECT_EQ(registers->dt_.peek(), 0x1);
+  EXPECT_EQ(registers->cycles_to_next_tick(), FREQ / 60);
+}
+
+TEST(idle, self_jump) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  memory->poke({0x12, 0x00}, 0x200);
+  registers->dt_.poke(0x5);
+
+  registers->trigger_timers();
+  romParser->step();
+  romParser->decode();
+
+  EXPECT_EQ(romParser->skip_idle(), FREQ / 60 - 2);
+  EXPECT_EQ(registers->pc_.peek(), 0x200);
+  EXPECT_EQ(registers->cycles_to_next_tick(), 1);
+  EXPECT_EQ(registers->dt_.peek(), 0x5);
+
+  registers->trigger_timers();
+  EXPECT_EQ(registers->dt_.peek(), 0x4);
+}
+
+TEST(idle, delay_timer_poll) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  // F307 (V3 = DT), 3300 (skip if V3 == 0), 1200 (jump back)
+  memory->poke({0xF3, 0x07, 0x33, 0x00, 0x12, 0x00}, 0x200);
+  registers->dt_.poke(0x2);
+
+  for (int i = 0; i < 2; i++) {
+    registers->trigger_timers();
+    romParser->step();
+    romParser->decode();
+    EXPECT_EQ(romParser->skip_idle(), 0);
+  }
+
+  // The jump closes the loop: 3 cycles elapsed, 4 left before the tick, one full iteration fits.
+  registers->trigger_timers();
+  romParser->step();
+  romParser->decode();
+  EXPECT_EQ(romParser->skip_idle(), 3);
+  EXPECT_EQ(registers->pc_.peek(), 0x200);
+  EXPECT_EQ(registers->v_[0x3].peek(), 0x2);
+  EXPECT_EQ(registers->cycles_to_next_tick(), FREQ / 60 - 6);
+}
+
+TEST(idle, delay_timer_poll_exits) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  memory->poke({0xF3, 0x07, 0x33, 0x00, 0x12, 0x00}, 0x200);
+  registers->v_[0x3].poke(0x1);
+  registers->pc_.poke(0x204);
+
+  // The timer reached the awaited value, the next iteration leaves the loop.
+  romParser->step();
+  romParser->decode();
+  EXPECT_EQ(romParser->skip_idle(), 0);
+
+  // Jumps that are not wait loops are left alone.
+  memory->poke({0x12, 0x02}, 0x204);
+  registers->pc_.poke(0x204);
+  romParser->step();
+  romParser->decode();
+  EXPECT_EQ(romParser->skip_idle(), 0);
+}
+
+TEST(idle, Fx0A_halts) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  romParser->set_opcode(0xF50A);
+  romParser->decode();
+
+  EXPECT_TRUE(registers->halted_);
+  EXPECT_EQ(registers->key_register_, 0x5);
+  EXPECT_EQ(registers->pc_.peek(), 0x200);
+  EXPECT_FALSE(instructions->resume_Fx0A());
+}
+
+TEST(idle, run_halted) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  // 6A05 (VA = 5), FA15 (DT = VA), F00A (wait for key), 1200
+  memory->poke({0x6A, 0x05, 0xFA, 0x15, 0xF0, 0x0A, 0x12, 0x00}, 0x200);
+
+  EXPECT_EQ(romParser->run(FREQ), 3);
+  EXPECT_TRUE(registers->halted_);
+  EXPECT_EQ(registers->pc_.peek(), 0x206);
+
+  // The timers kept running through the whole budget.
+  EXPECT_EQ(registers->dt_.peek(), 0x0);
+  EXPECT_EQ(registers->cycles_to_next_tick(), FREQ / 60 - FREQ % (FREQ / 60));
+
+  EXPECT_EQ(romParser->run(FREQ), 0);
+  EXPECT_EQ(registers->pc_.peek(), 0x206);
+}
+
+TEST(idle, run_budget) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  // Idle skipping never overruns the budget.
+  memory->poke({0x12, 0x00}, 0x200);
+  registers->dt_.poke(0xFF);
+
+  EXPECT_EQ(romParser->run(3), 3);
+  EXPECT_EQ(registers->cycles_to_next_tick(), FREQ / 60 - 3);
+
+  EXPECT_EQ(romParser->run(FREQ), FREQ);
+  EXPECT_EQ(registers->dt_.peek(), 0xFF - (FREQ + 3) / (FREQ / 60));
+}
@@ -15,11 +15,42 @@ const unsigned short int FREQ = 500;
 TEST(init, init_memory) {
   std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
 
-  for (mem::address_t i = memory->FONT_.size(); i < 4096; i++) { EXPECT_EQ(memory->peek(i), 0x0); }
+  mem::address_t fonts_end = memory->FONT_.size() + memory->BIG_FONT_.size();
+  for (mem::address_t i = fonts_end; i < 4096; i++) { EXPECT_EQ(memory->peek(i), 0x0); }
 
   for (mem::address_t i = 0; i < memory->FONT_.size(); i++) {
     EXPECT_EQ(memory->peek(i), memory->FONT_[i]);
   }
+
+  for (mem::address_t i = 0; i < memory->BIG_FONT_.size(); i++) {
+    EXPECT_EQ(memory->peek(memory->FONT_.size() + i), memory->BIG_FONT_[i]);
+  }
+}
+
+TEST(init, copy_on_write) {
+  mem::Memory memory;
+  mem::Memory other;
+  EXPECT_EQ(memory.get_private_pages(), 0);
+
+  // The first write to a shared page copies it
+  memory.poke(0x12, 0x300);
+  memory.poke(0x34, 0x301);
+  EXPECT_EQ(memory.get_private_pages(), 1);
+  EXPECT_EQ(memory.peek(0x300), 0x12);
+  EXPECT_EQ(other.peek(0x300), 0x0);
+  memory.poke(0xAB, 0x000);
+  EXPECT_EQ(memory.get_private_pages(), 2);
+  EXPECT_EQ(other.peek(0x000), memory.FONT_[0]);
+
+  // Copies share the pages until one of them writes
+  mem::image_t image = memory.get_image();
+  other.set_image(image);
+  EXPECT_EQ(memory.get_private_pages(), 0);
+  memory.poke(0x56, 0x300);
+  EXPECT_EQ(memory.peek(0x300), 0x56);
+  EXPECT_EQ(other.peek(0x300), 0x12);
+  EXPECT_EQ(image[0x3]->bytes[0x00], 0x12);
+  EXPECT_EQ(other.peek(0x301), 0x34);
 }
 
 TEST(init, init_registers) {
@@ -39,8 +70,10 @@ TEST(init, init_display) {
   std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
   std::shared_ptr<Interface> display = std::make_shared<Interface>(registers, true);
 
-  for (int x = 0; x < display->SIZE_X_; x++) {
-    for (int y = 0; y < display->SIZE_Y_; y++) { EXPECT_FALSE(display->is_pixel_on(x, y)); }
+  for (int x = 0; x < display->display_->size_x(); x++) {
+    for (int y = 0; y < display->display_->size_y(); y++) {
+      EXPECT_FALSE(display->display_->is_pixel_on(x, y));
+    }
   }
 }
 
@@ -65,19 +65,25 @@ TEST(instructions, 00E0) {
   std::shared_ptr<RomParser> romParser =
           std::make_shared<RomParser>(configuration, memory, registers, instructions);
 
-  for (int x = 0; x < interface->SIZE_X_; x++) {
-    for (int y = 0; y < interface->SIZE_Y_; y++) { interface->set_pixel_state(x, y, true); }
+  for (int x = 0; x < interface->display_->size_x(); x++) {
+    for (int y = 0; y < interface->display_->size_y(); y++) {
+      interface->display_->set_pixel_state(x, y, true);
+    }
   }
 
-  for (int x = 0; x < interface->SIZE_X_; x++) {
-    for (int y = 0; y < interface->SIZE_Y_; y++) { EXPECT_TRUE(interface->is_pixel_on(x, y)); }
+  for (int x = 0; x < interface->display_->size_x(); x++) {
+    for (int y = 0; y < interface->display_->size_y(); y++) {
+      EXPECT_TRUE(interface->display_->is_pixel_on(x, y));
+    }
   }
 
   romParser->set_opcode(0x00E0);
   romParser->decode();
 
-  for (int x = 0; x < interface->SIZE_X_; x++) {
-    for (int y = 0; y < interface->SIZE_Y_; y++) { EXPECT_FALSE(interface->is_pixel_on(x, y)); }
+  for (int x = 0; x < interface->display_->size_x(); x++) {
+    for (int y = 0; y < interface->display_->size_y(); y++) {
+      EXPECT_FALSE(interface->display_->is_pixel_on(x, y));
+    }
   }
 }
 
@@ -104,6 +110,9 @@ TEST(instructions, 00EE) {
 
   EXPECT_EQ(registers->pc_.peek(), 0x0FFF);
   EXPECT_EQ(registers->stack_.size(), 0);
+
+  EXPECT_EQ(romParser->decode(), Fault::stack_underflow);
+  EXPECT_EQ(registers->pc_.peek(), 0x0FFF);
 }
 
 TEST(instructions, 1nnn) {
@@ -147,6 +156,11 @@ TEST(instructions, 2nnn) {
   EXPECT_EQ(registers->stack_.size(), 1);
   EXPECT_EQ(registers->stack_.top(), 0x200);
   EXPECT_EQ(registers->pc_.peek(), 0xDEF);
+
+  for (int i = 1; i < reg::RegisterManager::STACK_SIZE; i++) { romParser->decode(); }
+  EXPECT_EQ(registers->stack_.size(), reg::RegisterManager::STACK_SIZE);
+  EXPECT_EQ(romParser->decode(), Fault::stack_overflow);
+  EXPECT_EQ(registers->stack_.size(), reg::RegisterManager::STACK_SIZE);
 }
 
 
@@ -811,11 +825,11 @@ TEST(instructions, Dxyn) {
   std::vector<bool> row2 = {true, false, false, true, false, false, false, false};
 
   for (int i = 0; i < 8; i++) {
-    EXPECT_EQ(interface->is_pixel_on(i, 0), row1[i]);
-    EXPECT_EQ(interface->is_pixel_on(i, 1), row2[i]);
-    EXPECT_EQ(interface->is_pixel_on(i, 2), row2[i]);
-    EXPECT_EQ(interface->is_pixel_on(i, 3), row2[i]);
-    EXPECT_EQ(interface->is_pixel_on(i, 4), row1[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 0), row1[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 1), row2[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 2), row2[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 3), row2[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 4), row1[i]);
   }
   EXPECT_EQ(registers->v_[0xf].peek(), 0x0);
 
@@ -828,8 +842,10 @@ TEST(instructions, Dxyn) {
   romParser->set_opcode(0xd005);
   romParser->decode();
 
-  for (int x = 0; x < interface->SIZE_X_; x++) {
-    for (int y = 0; y < interface->SIZE_Y_; y++) { EXPECT_FALSE(interface->is_pixel_on(x, y)); }
+  for (int x = 0; x < interface->display_->size_x(); x++) {
+    for (int y = 0; y < interface->display_->size_y(); y++) {
+      EXPECT_FALSE(interface->display_->is_pixel_on(x, y));
+    }
   }
   EXPECT_EQ(registers->v_[0xf].peek(), 0x1);
 
@@ -861,15 +877,17 @@ TEST(instructions, Dxyn) {
   EXPECT_EQ(registers->v_[0xf].peek(), 0x0);
 
   for (int i = 0; i < 64; i++) {
-    EXPECT_EQ(interface->is_pixel_on(i, 0), row3[i]);
-    EXPECT_EQ(interface->is_pixel_on(i, 1), row3[i]);
-    EXPECT_EQ(interface->is_pixel_on(i, 2), row4[i]);
-    EXPECT_EQ(interface->is_pixel_on(i, 30), row4[i]);
-    EXPECT_EQ(interface->is_pixel_on(i, 31), row3[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 0), row3[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 1), row3[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 2), row4[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 30), row4[i]);
+    EXPECT_EQ(interface->display_->is_pixel_on(i, 31), row3[i]);
   }
 
-  for (int x = 2; x < interface->SIZE_X_ - 2; x++) {
-    for (int y = 0; y < interface->SIZE_Y_; y++) { EXPECT_FALSE(interface->is_pixel_on(x, y)); }
+  for (int x = 2; x < interface->display_->size_x() - 2; x++) {
+    for (int y = 0; y < interface->display_->size_y(); y++) {
+      EXPECT_FALSE(interface->display_->is_pixel_on(x, y));
+    }
   }
 }
 
@@ -1142,7 +1160,9 @@ TEST(instructions, 00EA) {
           std::make_shared<RomParser>(configuration, memory, registers, instructions);
 
   romParser->set_opcode(0x800F);
-  EXPECT_THROW(romParser->decode(), std::runtime_error);
+  EXPECT_EQ(romParser->decode(), Fault::unknown_opcode);
+  EXPECT_TRUE(registers->faulted_);
+  EXPECT_EQ(registers->fault_, Fault::unknown_opcode);
 }
 
 TEST(instructions, 02D8) {
@@ -0,0 +1,120 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Memory.h"
+#include "gtest/gtest.h"
+#include <Instructions.h>
+#include <Interface.h>
+#include <Keypad.h>
+#include <RomParser.h>
+#include <memory>
+#include <register/RegisterManager.h>
+
+const unsigned short int FREQ = 500;
+
+TEST(keypad, mask) {
+  std::shared_ptr<Keypad> keypad = std::make_shared<Keypad>();
+
+  EXPECT_EQ(keypad->get_mask(), 0x0);
+  EXPECT_EQ(keypad->get_any_pressed(), 0x10);
+
+  keypad->press(0xA);
+  keypad->press(0x3);
+  EXPECT_EQ(keypad->get_mask(), 0x0408);
+  EXPECT_TRUE(keypad->is_pressed(0xA));
+  EXPECT_TRUE(keypad->is_pressed(0x3));
+  EXPECT_FALSE(keypad->is_pressed(0x0));
+  EXPECT_FALSE(keypad->is_pressed(0x13));
+  EXPECT_EQ(keypad->get_any_pressed(), 0x3);
+
+  keypad->release(0x3);
+  EXPECT_FALSE(keypad->is_pressed(0x3));
+  EXPECT_EQ(keypad->get_any_pressed(), 0xA);
+
+  keypad->set_mask(0x8000);
+  EXPECT_TRUE(keypad->is_pressed(0xF));
+  EXPECT_EQ(keypad->get_any_pressed(), 0xF);
+}
+
+TEST(keypad, keymap) {
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+
+  EXPECT_NO_THROW(interface->set_keymap("0123456789ABCDEF"));
+  EXPECT_THROW(interface->set_keymap("0123"), std::runtime_error);
+  EXPECT_THROW(interface->set_keymap("0123456789ABCDE#"), std::runtime_error);
+  EXPECT_THROW(interface->set_keymap("1123456789ABCDEF"), std::runtime_error);
+  // Names are not case sensitive
+  EXPECT_THROW(interface->set_keymap("0123456789ABCDEa"), std::runtime_error);
+}
+
+TEST(keypad, Ex9E) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  registers->v_[0x1].poke(0xC);
+
+  romParser->set_opcode(0xE19E);
+  romParser->decode();
+  EXPECT_EQ(registers->pc_.peek(), 0x200);
+
+  interface->keypad_->press(0xC);
+  romParser->decode();
+  EXPECT_EQ(registers->pc_.peek(), 0x202);
+}
+
+TEST(keypad, ExA1) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  registers->v_[0x1].poke(0xC);
+
+  romParser->set_opcode(0xE1A1);
+  romParser->decode();
+  EXPECT_EQ(registers->pc_.peek(), 0x202);
+
+  interface->keypad_->press(0xC);
+  romParser->decode();
+  EXPECT_EQ(registers->pc_.peek(), 0x202);
+}
+
+TEST(keypad, Fx0A) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  romParser->set_opcode(0xF50A);
+  romParser->decode();
+  EXPECT_TRUE(registers->halted_);
+
+  interface->keypad_->press(0x9);
+  EXPECT_TRUE(instructions->resume_Fx0A());
+  EXPECT_FALSE(registers->halted_);
+  EXPECT_EQ(registers->v_[0x5].peek(), 0x9);
+
+  // A key already down completes the instruction right away.
+  romParser->set_opcode(0xF60A);
+  romParser->decode();
+  EXPECT_FALSE(registers->halted_);
+  EXPECT_EQ(registers->v_[0x6].peek(), 0x9);
+}
@@ -0,0 +1,89 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Batch.h>
+#include <Lockstep.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+  const size_t INSTANCES = 37;
+
+  /**
+   * Random instructions, mostly register only, jumps staying in the ROM.
+   */
+  std::vector<uint8_t> make_rom(std::mt19937 & random, size_t size) {
+    const std::vector<op::Handler> handlers = {
+            op::Handler::ld_6xkk,  op::Handler::add_7xkk,  op::Handler::ld_8xy0,
+            op::Handler::or_8xy1,  op::Handler::and_8xy2,  op::Handler::xor_8xy3,
+            op::Handler::add_8xy4, op::Handler::sub_8xy5,  op::Handler::shr_8xy6,
+            op::Handler::subn_8xy7, op::Handler::shl_8xyE, op::Handler::se_3xkk,
+            op::Handler::sne_4xkk, op::Handler::se_5xy0,   op::Handler::sne_9xy0,
+            op::Handler::ld_Annn,  op::Handler::add_Fx1E,  op::Handler::ld_Fx29,
+            op::Handler::jp_1nnn,  op::Handler::jp_Bnnn,   op::Handler::rnd_Cxkk,
+            op::Handler::drw_Dxyn, op::Handler::skp_Ex9E,  op::Handler::ld_Fx0A,
+            op::Handler::ld_Fx07,  op::Handler::ld_Fx15,   op::Handler::ld_Fx55,
+            op::Handler::call_2nnn, op::Handler::ret_00EE, op::Handler::ld_F000};
+    std::vector<uint8_t> rom;
+    while (rom.size() < size) {
+      const op::Spec & spec = op::SPEC[static_cast<size_t>(handlers[random() % handlers.size()])];
+      op::opcode_t opcode = spec.pattern | (random() & ~spec.mask);
+      if (spec.handler == op::Handler::jp_1nnn || spec.handler == op::Handler::jp_Bnnn ||
+          spec.handler == op::Handler::call_2nnn) {
+        opcode = spec.pattern | (0x200 + (random() % (size / 2)) * 2);
+      }
+      rom.push_back(opcode >> 8);
+      rom.push_back(opcode & 0xFF);
+    }
+    return rom;
+  }
+}// namespace
+
+TEST(lanes, same_as_scalar) {
+  std::mt19937 random(7);
+
+  for (int rom_index = 0; rom_index < 30; rom_index++) {
+    std::shared_ptr<Configuration> configuration =
+            std::make_shared<Configuration>("", 500, rom_index % 2, rom_index % 3 == 0,
+                                            rom_index % 5 == 0, rom_index % 2);
+    configuration->setSeed(1 + rom_index);
+    configuration->setFaultPolicy(rom_index % 4 == 0 ? FaultPolicy::ignore : FaultPolicy::halt);
+    std::vector<uint8_t> rom = make_rom(random, 64 + random() % 192);
+
+    Batch scalar(configuration, rom, INSTANCES, 1, false);
+    Batch lanes(configuration, rom, INSTANCES, 3, true);
+
+    std::vector<uint16_t> actions(INSTANCES);
+    for (int step = 0; step < 30; step++) {
+      for (uint16_t & action : actions) { action = random() % 4 == 0 ? random() & 0xFFFF : 0x0; }
+      scalar.step(actions.data());
+      lanes.step(actions.data());
+
+      for (size_t index = 0; index < INSTANCES; index++) {
+        std::string diff = MachineState::capture(scalar.get_machine(index))
+                                   .diff(MachineState::capture(lanes.get_machine(index)));
+        ASSERT_EQ(diff, "") << "ROM " << rom_index << ", step " << step << ", instance " << index;
+        ASSERT_EQ(scalar.get_hashes()[index], lanes.get_hashes()[index]);
+      }
+    }
+  }
+}
+
+TEST(lanes, occupancy) {
+  // The same loop for every instance: every instruction but the draw runs lane-wise.
+  const std::vector<uint8_t> rom = {0x60, 0x00, 0x70, 0x01, 0x81, 0x04, 0x40, 0x20,
+                                    0x12, 0x00, 0xA2, 0x00, 0xD1, 0x01, 0x12, 0x02};
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("", 500, false, false, false, false);
+  Batch batch(configuration, rom, 32, 2);
+
+  std::vector<uint16_t> actions(32, 0x0);
+  for (int step = 0; step < 10; step++) { batch.step(actions.data()); }
+
+  LaneStats stats = batch.get_lane_stats();
+  EXPECT_GT(stats.vector, 0);
+  EXPECT_EQ(stats.lanes, stats.vector * LaneGroup::LANES);
+  EXPECT_LT(stats.scalar, stats.lanes / 4);
+}
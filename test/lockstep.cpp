@@ -0,0 +1,117 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Lockstep.h>
+#include <fstream>
+#include <memory>
+
+// Draws random sprites, then runs the superinstruction loops and a delay timer poll.
+const std::vector<uint8_t> PROGRAM = {
+        0xA2, 0x30, 0xC0, 0x3F, 0xC1, 0x1F, 0xD0, 0x15, 0x62, 0x05, 0xF2, 0x15, 0x73, 0x01,
+        0x33, 0x40, 0x12, 0x0C, 0x63, 0x00, 0xF4, 0x07, 0x34, 0x00, 0x12, 0x14, 0x75, 0x01,
+        0x45, 0x03, 0x12, 0x1A, 0x65, 0x00, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x90, 0x90, 0x90, 0xF0};
+
+void write_rom(const std::string & path) {
+  std::ofstream(path, std::ios_base::binary)
+          .write(reinterpret_cast<const char *>(PROGRAM.data()), PROGRAM.size());
+}
+
+TEST(lockstep, same_state) {
+  write_rom("./lockstep.ch8");
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./lockstep.ch8", 500, false, false, false, false);
+  configuration->setSeed(42);
+  Lockstep lockstep(configuration);
+
+  EXPECT_EQ(lockstep.run(2000), 2000);
+  EXPECT_FALSE(lockstep.has_diverged());
+  EXPECT_EQ(lockstep.get_report(), "");
+
+  // Superinstructions and skipped idle loops span up to a whole timer period
+  EXPECT_EQ(lockstep.run(5000, 50), 5000);
+  EXPECT_FALSE(lockstep.has_diverged());
+  EXPECT_LT(lockstep.get_candidate().romParser_->get_fusion_stats().dispatches,
+            lockstep.get_reference().romParser_->get_fusion_stats().dispatches);
+  EXPECT_TRUE(lockstep.get_reference().interface_->display_->get_row(0) != 0 ||
+              lockstep.get_reference().registers_->v_[0x1].peek() != 0);
+}
+
+TEST(lockstep, random_seed) {
+  write_rom("./lockstep.ch8");
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./lockstep.ch8", 500, false, false, false, false);
+  Lockstep lockstep(configuration);
+
+  EXPECT_NE(configuration->getSeed(), 0);
+  EXPECT_EQ(lockstep.run(500, 7), 500);
+  EXPECT_FALSE(lockstep.has_diverged());
+}
+
+TEST(lockstep, register_divergence) {
+  write_rom("./lockstep.ch8");
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./lockstep.ch8", 500, false, false, false, false);
+  configuration->setSeed(42);
+  Lockstep lockstep(configuration);
+
+  EXPECT_EQ(lockstep.run(10), 10);
+  lockstep.get_candidate().registers_->v_[0xE].poke(0x7);
+  lockstep.get_candidate().registers_->stack_.push(0x204);
+
+  EXPECT_EQ(lockstep.run(10), 0);
+  EXPECT_TRUE(lockstep.has_diverged());
+  EXPECT_NE(lockstep.get_report().find("Diverged within cycles 11 to 11"), std::string::npos);
+  EXPECT_NE(lockstep.get_report().find("v14: 0 != 0x7"), std::string::npos);
+  EXPECT_NE(lockstep.get_report().find("stack: [] != [0x204]"), std::string::npos);
+
+  // Stays stopped at the divergence
+  EXPECT_EQ(lockstep.run(10), 0);
+}
+
+TEST(lockstep, memory_divergence) {
+  write_rom("./lockstep.ch8");
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./lockstep.ch8", 500, false, false, false, false);
+  configuration->setSeed(42);
+  Lockstep lockstep(configuration);
+
+  // The sprite drawn at 0x206 differs
+  lockstep.get_candidate().memory_->poke(0xFF, 0x230);
+
+  EXPECT_EQ(lockstep.run(100, 4), 0);
+  EXPECT_NE(lockstep.get_report().find("from 0x200 LD I, 0x230"), std::string::npos);
+  EXPECT_NE(lockstep.get_report().find("memory digest"), std::string::npos);
+  EXPECT_NE(lockstep.get_report().find("display digest"), std::string::npos);
+  EXPECT_NE(lockstep.get_report().find("memory[0x230]: 0xF0 != 0xFF"), std::string::npos);
+  EXPECT_NE(lockstep.get_report().find("display: row "), std::string::npos);
+  EXPECT_THROW(lockstep.run(100, 0), std::runtime_error);
+}
+
+TEST(lockstep, end_of_memory) {
+  // JP 0xFFE, then runs the empty memory up to its end
+  std::ofstream("./lockstep_end.ch8", std::ios_base::binary).write("\x1F\xFE", 2);
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./lockstep_end.ch8", 500, false, false, false, false);
+  configuration->setSeed(42);
+  Lockstep lockstep(configuration);
+
+  EXPECT_NO_THROW(lockstep.run(100000, 1));
+  EXPECT_FALSE(lockstep.has_diverged());
+#if CHIP8_MEMORY_SIZE < 0x10000
+  EXPECT_TRUE(lockstep.get_reference().registers_->faulted_);
+  EXPECT_EQ(lockstep.get_reference().registers_->fault_, Fault::address_out_of_range);
+  EXPECT_EQ(lockstep.get_reference().registers_->fault_address_, mem::MEMORY_SIZE);
+#endif
+}
+
+TEST(lockstep, state_diff) {
+  MachineState a{};
+  MachineState b{};
+  EXPECT_EQ(a.diff(b), "");
+
+  b.pc = 0x202;
+  b.halted = true;
+  EXPECT_EQ(a.diff(b), "pc: 0 != 0x202\nhalted: 0 != 0x1\n");
+}
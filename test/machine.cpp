@@ -0,0 +1,125 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Machine.h>
+#include <csignal>
+#include <memory>
+
+namespace {
+  volatile std::sig_atomic_t traps = 0;
+
+  void count_trap(int) {
+    traps = traps + 1;
+  }
+
+  // Counts the beep requests of the ST writes
+  class BeepCounter : public Frontend {
+  public:
+    void mark_beep_request() override {
+      beeps++;
+    }
+
+    unsigned int beeps = 0;
+  };
+}// namespace
+
+TEST(machine, snapshot) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  Machine machine(configuration);
+
+  // Draws a random sprite, calls a subroutine, then stores and loads random registers.
+  machine.memory_->poke({0xC0, 0x3F, 0xA2, 0x20, 0xD0, 0x05, 0x22, 0x10, 0xC1, 0xFF, 0xC2, 0xFF,
+                         0xF2, 0x55, 0x12, 0x00, 0x63, 0x01, 0x00, 0xEE},
+                        0x200);
+  machine.interface_->keypad_->press(0x5);
+  Snapshot snapshot = machine.save();
+  uint64_t saved = machine.get_hash();
+
+  machine.romParser_->run(21);
+  uint64_t ran = machine.get_hash();
+  EXPECT_NE(ran, saved);
+  uint8_t v1 = machine.registers_->v_[0x1].peek();
+  uint8_t v2 = machine.registers_->v_[0x2].peek();
+  Display::row_t row = machine.interface_->display_->get_row(0);
+  EXPECT_EQ(machine.registers_->v_[0x3].peek(), 0x1);
+  EXPECT_EQ(machine.memory_->peek(0x222), v2);
+
+  machine.interface_->keypad_->release(0x5);
+  machine.interface_->display_->set_hires(true);
+  machine.restore(snapshot);
+
+  EXPECT_EQ(machine.registers_->pc_.peek(), 0x200);
+  EXPECT_EQ(machine.registers_->v_[0x3].peek(), 0x0);
+  EXPECT_EQ(machine.registers_->stack_.size(), 0);
+  EXPECT_EQ(machine.memory_->peek(0x222), 0x0);
+  EXPECT_FALSE(machine.interface_->display_->is_hires());
+  EXPECT_TRUE(machine.interface_->display_->get_row(0) == 0);
+  EXPECT_TRUE(machine.interface_->is_pressed(0x5));
+  EXPECT_EQ(machine.get_hash(), saved);
+
+  // Replays exactly, random numbers included
+  machine.romParser_->run(21);
+  EXPECT_EQ(machine.registers_->v_[0x1].peek(), v1);
+  EXPECT_EQ(machine.registers_->v_[0x2].peek(), v2);
+  EXPECT_TRUE(machine.interface_->display_->get_row(0) == row);
+  EXPECT_EQ(machine.memory_->peek(0x222), v2);
+  EXPECT_EQ(machine.get_hash(), ran);
+}
+
+TEST(machine, run_ahead) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  Machine machine(configuration);
+
+  // Waits for key 0, then draws the 0 glyph and loops.
+  machine.memory_->poke({0xE0, 0x9E, 0x12, 0x00, 0xF0, 0x29, 0xD0, 0x05, 0x12, 0x08}, 0x200);
+  machine.romParser_->run(10);
+  uint64_t hash = machine.get_hash();
+
+  EXPECT_TRUE(machine.run_ahead(2).get_row(0) == 0);
+  EXPECT_EQ(machine.get_hash(), hash);
+
+  machine.interface_->keypad_->press(0x0);
+  Display ahead = machine.run_ahead(1);
+  EXPECT_FALSE(ahead.get_row(0) == 0);
+
+  // The current state is untouched
+  EXPECT_TRUE(machine.interface_->display_->get_row(0) == 0);
+  EXPECT_TRUE(machine.interface_->is_pressed(0x0));
+  EXPECT_EQ(machine.registers_->exited_, false);
+  mem::address_t pc = machine.registers_->pc_.peek();
+  EXPECT_TRUE(pc == 0x200 || pc == 0x202);
+
+  machine.romParser_->run(machine.registers_->cycles_to_next_tick());
+  EXPECT_TRUE(machine.interface_->display_->get_row(0) == ahead.get_row(0));
+}
+
+TEST(machine, run_ahead_discards_side_effects) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  configuration->setFaultPolicy(FaultPolicy::trap);
+  auto registers = std::make_shared<reg::RegisterManager>(configuration->getFrequency());
+  auto frontend = std::make_shared<BeepCounter>();
+  Machine machine(configuration, registers, frontend);
+
+  // Beeps, then faults while key 0 is held
+  machine.memory_->poke({0x61, 0x05, 0xF1, 0x18, 0xE0, 0x9E, 0x12, 0x04, 0x00, 0xEE}, 0x200);
+  auto previous = std::signal(SIGTRAP, count_trap);
+  traps = 0;
+  machine.interface_->keypad_->press(0x0);
+
+  machine.run_ahead(2);
+  EXPECT_EQ(traps, 0);
+  EXPECT_EQ(frontend->beeps, 0U);
+  EXPECT_FALSE(machine.registers_->faulted_);
+
+  // The same frames run for real trap and beep
+  machine.romParser_->run(20);
+  EXPECT_EQ(traps, 1);
+  EXPECT_EQ(frontend->beeps, 1U);
+  EXPECT_TRUE(machine.registers_->faulted_);
+  EXPECT_EQ(machine.registers_->fault_, Fault::stack_underflow);
+  std::signal(SIGTRAP, previous);
+}
@@ -0,0 +1,55 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Opcodes.h>
+
+TEST(opcodes, table_matches_spec) {
+  for (uint32_t opcode = 0; opcode <= 0xFFFF; opcode++) {
+    const op::Spec & spec = op::get_spec(opcode);
+    EXPECT_EQ(opcode & spec.mask, spec.pattern) << std::hex << opcode;
+
+    // No later, more specific, instruction matches the opcode.
+    for (size_t i = static_cast<size_t>(spec.handler) + 1; i < op::SPEC.size(); i++) {
+      EXPECT_NE(opcode & op::SPEC[i].mask, op::SPEC[i].pattern) << std::hex << opcode;
+    }
+  }
+}
+
+TEST(opcodes, every_instruction_decodes) {
+  for (const op::Spec & spec : op::SPEC) {
+    if (spec.handler == op::Handler::unknown) { continue; }
+    EXPECT_EQ(op::TABLE[spec.pattern], spec.handler) << spec.mnemonic;
+    EXPECT_EQ(op::TABLE[spec.pattern | (~spec.mask & 0xFFFF)], spec.handler) << spec.mnemonic;
+  }
+}
+
+TEST(opcodes, unknown) {
+  EXPECT_EQ(op::TABLE[0x5121], op::Handler::unknown);
+  EXPECT_EQ(op::TABLE[0x800F], op::Handler::unknown);
+  EXPECT_EQ(op::TABLE[0xE0FF], op::Handler::unknown);
+  EXPECT_EQ(op::TABLE[0xF100], op::Handler::unknown);
+  EXPECT_EQ(op::TABLE[0xFFFF], op::Handler::unknown);
+}
+
+TEST(opcodes, operands) {
+  EXPECT_EQ(op::x(0xD12F), 0x1);
+  EXPECT_EQ(op::y(0xD12F), 0x2);
+  EXPECT_EQ(op::n(0xD12F), 0xF);
+  EXPECT_EQ(op::kk(0xD12F), 0x2F);
+  EXPECT_EQ(op::nnn(0xD12F), 0x12F);
+}
+
+TEST(opcodes, disassemble) {
+  EXPECT_EQ(op::disassemble(0x00E0), "CLS");
+  EXPECT_EQ(op::disassemble(0x0123), "SYS 0x123");
+  EXPECT_EQ(op::disassemble(0x00C4), "SCD 4");
+  EXPECT_EQ(op::disassemble(0x1A2B), "JP 0xA2B");
+  EXPECT_EQ(op::disassemble(0x3C0F), "SE VC, 0x0F");
+  EXPECT_EQ(op::disassemble(0x8AB4), "ADD VA, VB");
+  EXPECT_EQ(op::disassemble(0xD125), "DRW V1, V2, 5");
+  EXPECT_EQ(op::disassemble(0xE59E), "SKP V5");
+  EXPECT_EQ(op::disassemble(0xF365), "LD V3, [I]");
+  EXPECT_EQ(op::disassemble(0xF301), "PLANE 3");
+  EXPECT_EQ(op::disassemble(0xFFFF), "DW 0xFFFF");
+}
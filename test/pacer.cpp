@@ -0,0 +1,93 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <FramePacer.h>
+
+using namespace std::chrono;
+
+TEST(pacer, on_time) {
+  FramePacer pacer(4);
+  FramePacer::clock::time_point now{};
+
+  for (int i = 0; i < 10; i++) {
+    FramePacer::clock::time_point deadline = pacer.begin(milliseconds(16), now);
+    EXPECT_EQ(deadline, FramePacer::clock::time_point{} + milliseconds(16 * (i + 1)));
+    pacer.end(now + milliseconds(1));
+    EXPECT_TRUE(pacer.should_present());
+    pacer.mark_presented();
+    now = deadline;
+  }
+  // A frame that could not be queued is not presented
+  pacer.begin(milliseconds(16), now);
+  pacer.end(now + milliseconds(1));
+  EXPECT_TRUE(pacer.should_present());
+
+  EXPECT_EQ(pacer.get_stats().frames, 11);
+  EXPECT_EQ(pacer.get_stats().late, 0);
+  EXPECT_EQ(pacer.get_stats().presented, 10);
+  EXPECT_EQ(pacer.get_stats().skipped, 0);
+}
+
+TEST(pacer, catch_up) {
+  FramePacer pacer(2);
+  FramePacer::clock::time_point now{};
+
+  // Every period takes 20 ms out of 16: the schedule slips further behind each time
+  for (int i = 0; i < 6; i++) {
+    pacer.begin(milliseconds(16), now);
+    now += milliseconds(20);
+    pacer.end(now);
+    // Two skipped frames, then one presented
+    bool present = pacer.should_present();
+    EXPECT_EQ(present, i % 3 == 2);
+    if (present) { pacer.mark_presented(); }
+  }
+
+  EXPECT_EQ(pacer.get_stats().late, 6);
+  EXPECT_EQ(pacer.get_stats().presented, 2);
+  EXPECT_EQ(pacer.get_stats().skipped, 4);
+  EXPECT_DOUBLE_EQ(pacer.get_stats().max_lateness, 24);
+
+  // Faster periods run back to back until the schedule is caught up
+  EXPECT_LT(pacer.begin(milliseconds(16), now), now);
+  now += milliseconds(1);
+  pacer.end(now);
+  EXPECT_FALSE(pacer.should_present());
+  EXPECT_GT(pacer.begin(milliseconds(16), now), now);
+  now += milliseconds(1);
+  pacer.end(now);
+  EXPECT_TRUE(pacer.should_present());
+}
+
+TEST(pacer, no_skip) {
+  FramePacer pacer(0);
+  FramePacer::clock::time_point now{};
+
+  for (int i = 0; i < 4; i++) {
+    pacer.begin(milliseconds(16), now);
+    now += milliseconds(32);
+    pacer.end(now);
+    EXPECT_TRUE(pacer.should_present());
+  }
+
+  EXPECT_EQ(pacer.get_stats().late, 4);
+  EXPECT_EQ(pacer.get_stats().skipped, 0);
+}
+
+TEST(pacer, resync) {
+  FramePacer pacer(4);
+  FramePacer::clock::time_point now{};
+
+  pacer.begin(milliseconds(16), now);
+  now += milliseconds(500);
+  pacer.end(now);
+  EXPECT_FALSE(pacer.should_present());
+
+  // The stall is not caught up
+  FramePacer::clock::time_point deadline = pacer.begin(milliseconds(16), now);
+  EXPECT_EQ(deadline, now + milliseconds(16));
+  EXPECT_EQ(pacer.get_stats().resyncs, 1);
+  pacer.end(now + milliseconds(1));
+  EXPECT_TRUE(pacer.should_present());
+}
@@ -0,0 +1,177 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <Memory.h>
+#include <QuirkDatabase.h>
+#include <QuirkSweep.h>
+#include <fstream>
+#include <vector>
+
+#include "Aot.h"
+
+namespace {
+  /**
+   * Faults without -1, and with -3, draws the VF left by OR: 0 with -2 and -4, 1 otherwise.
+   */
+  const std::vector<uint8_t> ROM = {
+          0x61, 0x02,// LD V1, 2
+          0x62, 0x05,// LD V2, 5
+          0x81, 0x26,// SHR V1, V2: 1, or 2 with -1
+          0x31, 0x02,// SE V1, 2
+          0x00, 0xEE,// RET: stack underflow
+          0xF0, 0x00,// LD I, MEMORY_SIZE - 2
+          static_cast<uint8_t>((mem::MEMORY_SIZE - 2) >> 8), (mem::MEMORY_SIZE - 2) & 0xFF,
+          0xF0, 0x55,// LD [I], V0: I = MEMORY_SIZE - 1 with -3
+          0xF1, 0x55,// LD [I], V1
+          0x6F, 0x01,// LD VF, 1
+          0x80, 0x11,// OR V0, V1: VF = 0 with -4
+          0x62, 0x04,// LD V2, 4
+          0xB2, 0x1A,// JP V0, 0x21A: 0x21C, or 0x21E with -2
+          0x6F, 0x01,// LD VF, 1
+          0x6F, 0x01,// LD VF, 1
+          0xFF, 0x29,// LD F, VF
+          0x60, 0x00,// LD V0, 0
+          0xD0, 0x05,// DRW V0, V0, 5
+          0x7E, 0x01,// ADD VE, 1
+          0x12, 0x24,// JP 0x224
+  };
+}// namespace
+
+TEST(quirks, format) {
+  EXPECT_EQ(quirk::format(0x0), "----");
+  EXPECT_EQ(quirk::format(quirk::SHIFT_SETS_VY | quirk::LOGIC_RESETS_VF), "1--4");
+  for (unsigned int quirks = 0; quirks < quirk::COMBINATIONS; quirks++) {
+    EXPECT_EQ(quirk::parse(quirk::format(quirks)), quirks);
+    EXPECT_EQ(quirk::get_quirks(*quirk::make_configuration("", 500, quirks)), quirks);
+  }
+  EXPECT_THROW(quirk::parse("1-3"), std::runtime_error);
+  EXPECT_THROW(quirk::parse("2---"), std::runtime_error);
+}
+
+TEST(quirks, database) {
+  const std::string path = "quirks_test.txt";
+  std::remove(path.c_str());
+  {
+    QuirkDatabase database(path);
+    EXPECT_EQ(database.size(), 0);
+    database.set(0x0123456789ABCDEF, 0x5, "game.ch8");
+    database.set(0x42, 0x0, "");
+    database.save();
+  }
+
+  QuirkDatabase database(path);
+  EXPECT_EQ(database.size(), 2);
+  EXPECT_EQ(database.find(0x0123456789ABCDEF), 0x5U);
+  EXPECT_EQ(database.find(0x42), 0x0U);
+  EXPECT_FALSE(database.find(0x43));
+
+  std::ofstream(path, std::ios_base::binary).write(reinterpret_cast<const char *>(ROM.data()),
+                                                   ROM.size());
+  EXPECT_FALSE(database.find_rom(path));
+  database.set(chip8_aot_hash(ROM.data(), ROM.size()), 0x1, "sweep.ch8");
+  EXPECT_EQ(database.find_rom(path), 0x1U);
+  EXPECT_FALSE(database.find_rom("missing.ch8"));
+
+  std::ofstream(path) << "# comment\n0123456789ABCDEF 1--4 name\nnot-a-hash ----\n";
+  EXPECT_THROW(QuirkDatabase{path}, std::runtime_error);
+  std::ofstream(path) << "0123456789ABCDEF 1-5-\n";
+  EXPECT_THROW(QuirkDatabase{path}, std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(quirks, sweep) {
+  QuirkSweep sweep(ROM, 500);
+  sweep.run(20000, 4);
+
+  const std::vector<QuirkResult> & results = sweep.get_results();
+  ASSERT_EQ(results.size(), quirk::COMBINATIONS);
+  for (unsigned int quirks = 0; quirks < quirk::COMBINATIONS; quirks++) {
+    const QuirkResult & result = results[quirks];
+    EXPECT_EQ(result.quirks, quirks);
+    if (!(quirks & quirk::SHIFT_SETS_VY)) {
+      EXPECT_EQ(result.outcome, Outcome::faulted) << quirks;
+      EXPECT_EQ(result.fault, Fault::stack_underflow);
+    } else if (quirks & quirk::LOAD_STORE_INCREMENTS_I) {
+      EXPECT_EQ(result.outcome, Outcome::faulted) << quirks;
+      EXPECT_EQ(result.fault, Fault::address_out_of_range);
+    } else {
+      EXPECT_EQ(result.outcome, Outcome::completed) << quirks;
+      EXPECT_EQ(result.cycles, 20000);
+      EXPECT_EQ(result.diverged, quirks == 0xB) << quirks;
+    }
+  }
+  // The sprite is drawn by the 14th instruction, in the second frame
+  EXPECT_EQ(results[0xB].divergence_frame, 1);
+  EXPECT_FALSE(sweep.is_ambiguous());
+  EXPECT_EQ(sweep.get_recommended(), quirk::SHIFT_SETS_VY);
+
+  // Threads only change the order the combinations run in
+  QuirkSweep serial(ROM, 500);
+  serial.run(20000, 1);
+  for (unsigned int quirks = 0; quirks < quirk::COMBINATIONS; quirks++) {
+    EXPECT_EQ(serial.get_results()[quirks].display_digest, results[quirks].display_digest);
+    EXPECT_EQ(serial.get_results()[quirks].cycles, results[quirks].cycles);
+  }
+}
+
+TEST(quirks, stalled) {
+  // Draws the VF left by SHR then OR: 1 with -1 and without -4, 0 otherwise, then jumps to itself
+  const std::vector<uint8_t> rom = {
+          0x61, 0x02,// LD V1, 2
+          0x62, 0x05,// LD V2, 5
+          0x81, 0x26,// SHR V1, V2: VF = 0, or 1 with -1
+          0x81, 0x01,// OR V1, V0: VF = 0 with -4
+          0xFF, 0x29,// LD F, VF
+          0xD0, 0x05,// DRW V0, V0, 5
+          0x12, 0x0C,// JP 0x20C
+  };
+  QuirkSweep sweep(rom, 500);
+  sweep.run(20000, 4);
+
+  // Stalled combinations still count with their last frame
+  for (const QuirkResult & result : sweep.get_results()) {
+    bool diverged = (result.quirks & quirk::SHIFT_SETS_VY) &&
+                    !(result.quirks & quirk::LOGIC_RESETS_VF);
+    EXPECT_EQ(result.outcome, Outcome::stalled);
+    EXPECT_EQ(result.diverged, diverged) << result.quirks;
+  }
+  EXPECT_EQ(sweep.get_results()[0x1].divergence_frame, 0);
+  // 12 combinations on one frame, 4 on the other
+  EXPECT_FALSE(sweep.is_ambiguous());
+  EXPECT_EQ(sweep.get_recommended(), 0x0U);
+}
+
+TEST(quirks, ambiguous) {
+  // Draws 1, or 2 with -1, then jumps to itself
+  const std::vector<uint8_t> rom = {
+          0x61, 0x02,// LD V1, 2
+          0x62, 0x05,// LD V2, 5
+          0x81, 0x26,// SHR V1, V2: 1, or 2 with -1
+          0xF1, 0x29,// LD F, V1
+          0xD0, 0x05,// DRW V0, V0, 5
+          0x12, 0x0A,// JP 0x20A
+  };
+  QuirkSweep sweep(rom, 500);
+  sweep.run(20000, 4);
+
+  // 8 combinations on each frame, no frame is expected over the other
+  EXPECT_NE(sweep.get_results()[0x0].display_digest, sweep.get_results()[0x1].display_digest);
+  for (const QuirkResult & result : sweep.get_results()) {
+    EXPECT_EQ(result.outcome, Outcome::stalled);
+    EXPECT_FALSE(result.diverged) << result.quirks;
+  }
+  EXPECT_TRUE(sweep.is_ambiguous());
+  EXPECT_FALSE(sweep.get_recommended());
+}
+
+TEST(quirks, no_recommendation) {
+  // Faults under every combination
+  QuirkSweep sweep({0x00, 0xEE}, 500);
+  sweep.run(20000, 2);
+  for (const QuirkResult & result : sweep.get_results()) {
+    EXPECT_EQ(result.outcome, Outcome::faulted);
+  }
+  EXPECT_FALSE(sweep.is_ambiguous());
+  EXPECT_FALSE(sweep.get_recommended());
+}
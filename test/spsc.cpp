@@ -0,0 +1,61 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <SpscQueue.h>
+#include <atomic>
+#include <thread>
+
+TEST(spsc, full_and_empty) {
+  SpscQueue<int, 4> queue;
+  int item = 0;
+
+  EXPECT_FALSE(queue.pop(item));
+  for (int i = 0; i < 4; i++) { EXPECT_TRUE(queue.push(i)); }
+  EXPECT_FALSE(queue.push(4));
+
+  EXPECT_TRUE(queue.pop(item));
+  EXPECT_EQ(item, 0);
+  EXPECT_TRUE(queue.push(4));
+
+  for (int i = 1; i <= 4; i++) {
+    EXPECT_TRUE(queue.pop(item));
+    EXPECT_EQ(item, i);
+  }
+  EXPECT_FALSE(queue.pop(item));
+}
+
+TEST(spsc, threads) {
+  const int COUNT = 200000;
+  SpscQueue<int, 8> queue;
+  // Set by the consumer on a mismatch, so the producer does not wait for it forever
+  std::atomic<bool> stop{false};
+
+  std::thread producer([&queue, &stop]() {
+    for (int i = 0; i < COUNT; i++) {
+      while (!queue.push(i)) {
+        if (stop) { return; }
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  // Items arrive in order, none lost or duplicated
+  int expected = 0;
+  int item = 0;
+  while (expected < COUNT) {
+    if (!queue.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (item != expected) {
+      stop = true;
+      break;
+    }
+    expected++;
+  }
+  producer.join();
+
+  EXPECT_EQ(expected, COUNT);
+  EXPECT_FALSE(queue.pop(item));
+}
@@ -0,0 +1,117 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "gtest/gtest.h"
+#include <VideoWriter.h>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+  const std::string HEADER = "YUV4MPEG2 W128 H64 F60:1 Ip A1:1 Cmono\n";
+  const size_t FRAME_SIZE = 6 + VideoWriter::WIDTH * VideoWriter::HEIGHT;
+}// namespace
+
+TEST(video, y4m) {
+  const std::string path = "video_test.y4m";
+  Display display;
+  {
+    VideoWriter video(path);
+    display.set_pixel_state(3, 4, true);
+    EXPECT_TRUE(video.push(display));
+    display.set_hires(true);
+    display.set_pixel_state(127, 63, true);
+    EXPECT_TRUE(video.push(display));
+    video.finish();
+    EXPECT_FALSE(video.push(display));
+
+    VideoStats stats = video.get_stats();
+    EXPECT_EQ(stats.written, 2);
+    EXPECT_EQ(stats.dropped, 1);
+  }
+
+  std::ifstream source(path, std::ios_base::binary);
+  std::string video((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+  ASSERT_EQ(video.size(), HEADER.size() + 2 * FRAME_SIZE);
+  EXPECT_EQ(video.substr(0, HEADER.size()), HEADER);
+
+  // Low resolution pixels are doubled
+  const char * frame = video.data() + HEADER.size();
+  EXPECT_EQ(std::string(frame, 6), "FRAME\n");
+  const auto * pixels = reinterpret_cast<const uint8_t *>(frame + 6);
+  size_t lit = 0;
+  for (size_t i = 0; i < VideoWriter::WIDTH * VideoWriter::HEIGHT; i++) { lit += pixels[i] != 0; }
+  EXPECT_EQ(lit, 4);
+  EXPECT_EQ(pixels[8 * VideoWriter::WIDTH + 6], 0xFF);
+  EXPECT_EQ(pixels[9 * VideoWriter::WIDTH + 7], 0xFF);
+
+  frame += FRAME_SIZE;
+  pixels = reinterpret_cast<const uint8_t *>(frame + 6);
+  EXPECT_EQ(pixels[63 * VideoWriter::WIDTH + 127], 0xFF);
+  EXPECT_EQ(pixels[9 * VideoWriter::WIDTH + 7], 0x0);
+  std::remove(path.c_str());
+
+  EXPECT_THROW(VideoWriter("missing/video.y4m"), std::runtime_error);
+}
+
+TEST(video, drops) {
+  int pipe_fds[2];
+  ASSERT_EQ(pipe(pipe_fds), 0);
+  auto video = std::make_unique<VideoWriter>("/dev/fd/" + std::to_string(pipe_fds[1]));
+  close(pipe_fds[1]);
+
+  // Nothing reads the pipe: once it and the queue are full, the frames are dropped
+  Display display;
+  const unsigned long frames = 200;
+  for (unsigned long i = 0; i < frames; i++) { video->push(display); }
+  EXPECT_GT(video->get_stats().dropped, 0);
+
+  size_t size = 0;
+  std::thread reader([&]() {
+    char buffer[4096];
+    for (ssize_t read_size; (read_size = read(pipe_fds[0], buffer, sizeof(buffer))) > 0;) {
+      size += read_size;
+    }
+  });
+  video->finish();
+  VideoStats stats = video->get_stats();
+  video.reset();
+  reader.join();
+  close(pipe_fds[0]);
+
+  EXPECT_EQ(stats.written + stats.dropped, frames);
+  EXPECT_EQ(size, HEADER.size() + stats.written * FRAME_SIZE);
+}
+
+TEST(video, stalled_reader) {
+  int pipe_fds[2];
+  ASSERT_EQ(pipe(pipe_fds), 0);
+  VideoWriter video("/dev/fd/" + std::to_string(pipe_fds[1]));
+  close(pipe_fds[1]);
+
+  // The pipe is never read: finishing gives up on the reader instead of waiting for it
+  Display display;
+  const unsigned long frames = 200;
+  for (unsigned long i = 0; i < frames; i++) {
+    video.push(display);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  auto start = std::chrono::steady_clock::now();
+  video.finish();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 4 * VideoWriter::FINISH_TIMEOUT);
+  close(pipe_fds[0]);
+
+  VideoStats stats = video.get_stats();
+  EXPECT_GT(stats.dropped, 0);
+  EXPECT_EQ(stats.written + stats.dropped, frames);
+}
+
+TEST(video, gray) {
+  EXPECT_EQ(VideoWriter::get_gray(0x0), 0);
+  EXPECT_EQ(VideoWriter::get_gray(0x1), 255);
+  EXPECT_EQ(VideoWriter::get_gray(0x2), 0xAA);
+  EXPECT_EQ(VideoWriter::get_gray(0x3), 0x55);
+}
@@ -0,0 +1,217 @@
+// (c) 2021 Maxandre Ogeret
+// Licensed under MIT License
+
+#include "Memory.h"
+#include "gtest/gtest.h"
+#include <Display.h>
+#include <Instructions.h>
+#include <Interface.h>
+#include <RomParser.h>
+#include <memory>
+#include <register/RegisterManager.h>
+
+const unsigned short int FREQ = 500;
+
+TEST(xochip, memory_size) {
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+
+  EXPECT_NO_THROW(memory->poke(0x42, mem::MEMORY_SIZE - 1));
+  EXPECT_EQ(memory->peek(mem::MEMORY_SIZE - 1), 0x42);
+  EXPECT_THROW(memory->poke({0x1, 0x2}, mem::MEMORY_SIZE - 1), std::runtime_error);
+#if CHIP8_MEMORY_SIZE < 0x10000
+  EXPECT_THROW(memory->peek(mem::MEMORY_SIZE), std::runtime_error);
+#endif
+}
+
+TEST(xochip, F000) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  memory->poke({0xF0, 0x00, 0xAB, 0xCD}, 0x200);
+  registers->pc_.poke(0x200);
+  romParser->step();
+  romParser->decode();
+
+  EXPECT_EQ(registers->i_.peek(), 0xABCD);
+  EXPECT_EQ(registers->pc_.peek(), 0x204);
+}
+
+TEST(xochip, skip_F000) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  // The skipped F000 NNNN is 4 bytes long
+  memory->poke({0x30, 0x00, 0xF0, 0x00, 0x12, 0x34, 0x30, 0x00, 0x60, 0x01}, 0x200);
+  registers->pc_.poke(0x200);
+  romParser->step();
+  romParser->decode();
+  EXPECT_EQ(registers->pc_.peek(), 0x206);
+
+  romParser->step();
+  romParser->decode();
+  EXPECT_EQ(registers->pc_.peek(), 0x20A);
+}
+
+TEST(xochip, 5xy2_5xy3) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  for (uint8_t i = 0; i <= 0xF; i++) { registers->v_[i].poke(i + 1); }
+  registers->i_.poke(0x300);
+
+  romParser->set_opcode(0x5352);
+  romParser->decode();
+  EXPECT_EQ(memory->peek(0x300), 0x4);
+  EXPECT_EQ(memory->peek(0x301), 0x5);
+  EXPECT_EQ(memory->peek(0x302), 0x6);
+  EXPECT_EQ(registers->i_.peek(), 0x300);
+
+  // Reverse order
+  romParser->set_opcode(0x5A83);
+  romParser->decode();
+  EXPECT_EQ(registers->v_[0xA].peek(), 0x4);
+  EXPECT_EQ(registers->v_[0x9].peek(), 0x5);
+  EXPECT_EQ(registers->v_[0x8].peek(), 0x6);
+  EXPECT_EQ(registers->i_.peek(), 0x300);
+
+  romParser->set_opcode(0x5121);
+  EXPECT_EQ(romParser->decode(), Fault::unknown_opcode);
+}
+
+TEST(xochip, 00Dn) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  interface->display_->set_pixel_state(5, 10, true);
+
+  romParser->set_opcode(0x00D3);
+  romParser->decode();
+  EXPECT_TRUE(interface->display_->is_pixel_on(5, 7));
+  EXPECT_FALSE(interface->display_->is_pixel_on(5, 10));
+}
+
+TEST(xochip, Fn01) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  EXPECT_EQ(interface->display_->get_planes(), 0x1);
+
+  // Planes that do not exist are ignored
+  romParser->set_opcode(0xFF01);
+  romParser->decode();
+  EXPECT_EQ(interface->display_->get_planes(), (1 << Display::PLANES) - 1);
+
+  romParser->set_opcode(0xF001);
+  romParser->decode();
+  EXPECT_EQ(interface->display_->get_planes(), 0x0);
+
+  // Drawing on no plane does nothing
+  registers->i_.poke(0x0);
+  romParser->set_opcode(0xD005);
+  romParser->decode();
+  EXPECT_FALSE(interface->display_->is_pixel_on(0, 0));
+}
+
+#if CHIP8_PLANES > 1
+TEST(xochip, planes) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  // One row for plane 0, then one for plane 1
+  memory->poke({0xC0, 0x60}, 0x300);
+  registers->i_.poke(0x300);
+
+  romParser->set_opcode(0xF301);
+  romParser->decode();
+  romParser->set_opcode(0xD001);
+  romParser->decode();
+
+  EXPECT_EQ(interface->display_->get_color(0, 0), 0x1);
+  EXPECT_EQ(interface->display_->get_color(1, 0), 0x3);
+  EXPECT_EQ(interface->display_->get_color(2, 0), 0x2);
+  EXPECT_EQ(registers->v_[0xf].peek(), 0x0);
+
+  // Clearing plane 0 keeps plane 1
+  romParser->set_opcode(0xF101);
+  romParser->decode();
+  romParser->set_opcode(0x00E0);
+  romParser->decode();
+  EXPECT_EQ(interface->display_->get_color(1, 0), 0x2);
+}
+#endif
+
+TEST(xochip, F002_Fx3A) {
+  std::shared_ptr<Configuration> configuration =
+          std::make_shared<Configuration>("./cls.ch8", 500, false, false, false, false);
+  std::shared_ptr<mem::Memory> memory = std::make_shared<mem::Memory>();
+  std::shared_ptr<reg::RegisterManager> registers = std::make_shared<reg::RegisterManager>(FREQ);
+  std::shared_ptr<Interface> interface = std::make_shared<Interface>(registers, true);
+  std::shared_ptr<Instructions> instructions =
+          std::make_shared<Instructions>(configuration, memory, registers, interface);
+  std::shared_ptr<RomParser> romParser =
+          std::make_shared<RomParser>(configuration, memory, registers, instructions);
+
+  for (uint8_t i = 0; i < 16; i++) { memory->poke(0xF0 + i, 0x300 + i); }
+  registers->i_.poke(0x300);
+  romParser->set_opcode(0xF002);
+  romParser->decode();
+
+  EXPECT_TRUE(registers->audio_pattern_loaded_);
+  for (uint8_t i = 0; i < 16; i++) { EXPECT_EQ(registers->audio_pattern_[i], 0xF0 + i); }
+
+  registers->v_[0x4].poke(112);
+  romParser->set_opcode(0xF43A);
+  romParser->decode();
+  EXPECT_EQ(registers->pitch_, 112);
+
+  // 4000 bits per second at pitch 64, an octave every 48 steps
+  EXPECT_EQ(Interface::get_pattern_increment(64, 4000), 1 << (32 - PATTERN_BITS));
+  EXPECT_EQ(Interface::get_pattern_increment(112, 4000), 2 << (32 - PATTERN_BITS));
+  EXPECT_EQ(Interface::get_pattern_increment(16, 4000), 1 << (31 - PATTERN_BITS));
+
+  registers->st_.poke(0x2);
+  interface->toogle_buzzer();
+  EXPECT_TRUE(interface->is_buzzing());
+}